@@ -17,13 +17,16 @@ UTIL_DIR = $$SOURCEDIR/util
 WRL_DIR  = $$SOURCEDIR/wrl
 
 SOURCES += \
+	$$SOURCEDIR/core/ConcurrentPartition.cpp \
 	$$SOURCEDIR/core/Edges.cpp \
 	$$SOURCEDIR/core/Faces.cpp \
 	$$SOURCEDIR/core/Graph.cpp \
 	$$SOURCEDIR/core/HalfEdges.cpp \
+	$$SOURCEDIR/core/OccupancyGrid.cpp \
 	$$SOURCEDIR/core/Partition.cpp \
 	$$SOURCEDIR/core/PolygonMesh.cpp \
 	$$SOURCEDIR/core/PolygonMeshTest.cpp \
+	$$SOURCEDIR/core/TriangleHalfEdges.cpp \
 #
 	$$SOURCEDIR/gui/GuiAboutDialog.cpp \
 	$$SOURCEDIR/gui/GuiGLBuffer.cpp \
@@ -41,6 +44,7 @@ SOURCES += \
 	$$SOURCEDIR/io/LoaderPly.cpp \
 	$$SOURCEDIR/io/LoaderStl.cpp \
 	$$SOURCEDIR/io/LoaderWrl.cpp \
+	$$SOURCEDIR/io/NumberParser.cpp \
 	$$SOURCEDIR/io/SaverPly.cpp \
 	$$SOURCEDIR/io/SaverStl.cpp \
 	$$SOURCEDIR/io/SaverWrl.cpp \
@@ -50,6 +54,7 @@ SOURCES += \
 #
 	$$SOURCEDIR/util/BBox.cpp \
 	$$SOURCEDIR/util/Endian.cpp \
+	$$SOURCEDIR/util/Parallel.cpp \
 	$$SOURCEDIR/util/StaticRotation.cpp \
 #
 	$$SOURCEDIR/wrl/Ply.cpp \
@@ -66,19 +71,24 @@ SOURCES += \
 	$$SOURCEDIR/wrl/SceneGraph.cpp \
 	$$SOURCEDIR/wrl/SceneGraphProcessor.cpp \
 	$$SOURCEDIR/wrl/SceneGraphTraversal.cpp \
+	$$SOURCEDIR/wrl/SceneGraphFlat.cpp \
+	$$SOURCEDIR/wrl/SceneGraphSnapshot.cpp \
 	$$SOURCEDIR/wrl/Shape.cpp \
 	$$SOURCEDIR/wrl/Transform.cpp \
 #
         $$(NULL)
 
 HEADERS += \
+	$$SOURCEDIR/core/ConcurrentPartition.hpp \
 	$$SOURCEDIR/core/Edges.hpp \
 	$$SOURCEDIR/core/Faces.hpp \
 	$$SOURCEDIR/core/Graph.hpp \
 	$$SOURCEDIR/core/HalfEdges.hpp \
+	$$SOURCEDIR/core/OccupancyGrid.hpp \
 	$$SOURCEDIR/core/Partition.hpp \
 	$$SOURCEDIR/core/PolygonMesh.hpp \
 	$$SOURCEDIR/core/PolygonMeshTest.hpp \
+	$$SOURCEDIR/core/TriangleHalfEdges.hpp \
 #
 	$$SOURCEDIR/gui/GuiAboutDialog.hpp \
 	$$SOURCEDIR/gui/GuiGLBuffer.hpp \
@@ -97,6 +107,7 @@ HEADERS += \
 	$$SOURCEDIR/io/LoaderPly.hpp \
 	$$SOURCEDIR/io/LoaderStl.hpp \
 	$$SOURCEDIR/io/LoaderWrl.hpp \
+	$$SOURCEDIR/io/NumberParser.hpp \
 	$$SOURCEDIR/io/Saver.hpp \
 	$$SOURCEDIR/io/SaverPly.hpp \
 	$$SOURCEDIR/io/SaverStl.hpp \
@@ -109,6 +120,8 @@ HEADERS += \
 	$$SOURCEDIR/util/CastMacros.hpp \
 	$$SOURCEDIR/util/BBox.hpp \
 	$$SOURCEDIR/util/Endian.hpp \
+	$$SOURCEDIR/util/Parallel.hpp \
+	$$SOURCEDIR/util/SharedArray.hpp \
 	$$SOURCEDIR/util/StaticRotation.hpp \
 #
 	$$SOURCEDIR/wrl/Ply.hpp \
@@ -125,6 +138,8 @@ HEADERS += \
 	$$SOURCEDIR/wrl/SceneGraph.hpp \
 	$$SOURCEDIR/wrl/SceneGraphProcessor.hpp \
 	$$SOURCEDIR/wrl/SceneGraphTraversal.hpp \
+	$$SOURCEDIR/wrl/SceneGraphFlat.hpp \
+	$$SOURCEDIR/wrl/SceneGraphSnapshot.hpp \
 	$$SOURCEDIR/wrl/Shape.hpp \
 	$$SOURCEDIR/wrl/Transform.hpp \
 #
@@ -9,6 +9,7 @@ NAME = DGP2025-A2
 unix:!macx:CONFIG += USE_UNIX_DAEMONIZE
 
 # CONFIG += c++11 c++14 c++17
+CONFIG += c++17
 CONFIG += sdk_no_version_check
 
 ##########################################################################
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// ConcurrentPartition.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "ConcurrentPartition.hpp"
+#include <util/Parallel.hpp>
+
+ConcurrentPartition::ConcurrentPartition(const int nElements):
+  _nParts(0),
+  _parent(),
+  _part()
+{
+  reset(nElements);
+}
+
+void ConcurrentPartition::reset(const int nElements) {
+  int n = (nElements>0)?nElements:0;
+  _nParts = n;
+  _parent = vector<atomic<int>>(n);
+  _part.clear();
+  for(int i=0;i<n;i++)
+    _parent[i].store(i,memory_order_relaxed);
+}
+
+int ConcurrentPartition::getNumberOfElements() const {
+  return static_cast<int>(_parent.size());
+}
+
+int ConcurrentPartition::getNumberOfParts() const {
+  return _nParts.load();
+}
+
+int ConcurrentPartition::find(const int i) {
+  if(i<0) return -1;
+  if(i>=getNumberOfElements()) return -1;
+  int j=i,Pj,PPj;
+  while((Pj=_parent[j].load(memory_order_acquire))!=j) {
+    PPj = _parent[Pj].load(memory_order_acquire);
+    // path halving: try to make j point to its grandparent; if the
+    // exchange fails another thread has already shortened the path
+    if(PPj!=Pj)
+      _parent[j].compare_exchange_weak(Pj,PPj,memory_order_acq_rel);
+    j = PPj;
+  }
+  return j;
+}
+
+int ConcurrentPartition::join(const int i, const int j) {
+  int Ri,Rj,R;
+  for(;;) {
+    Ri = find(i);
+    Rj = find(j);
+    if(Ri<0 || Rj<0) return -1;
+    if(Ri==Rj) return Ri;
+    // make the smaller root the root of the joined part
+    if(Ri<Rj) { R=Ri; Ri=Rj; Rj=R; }
+    R = Ri;
+    if(_parent[Ri].compare_exchange_strong(R,Rj,memory_order_acq_rel)) {
+      _nParts--;
+      return Rj;
+    }
+    // Ri is no longer a root; try again
+  }
+}
+
+void ConcurrentPartition::joinAll(const vector<int>& pairs, const int nThreads) {
+  int nPairs = static_cast<int>(pairs.size()/2);
+  Parallel::forRanges(nThreads,nPairs,[&](int /*k*/, int k0, int k1) {
+      for(int k=k0;k<k1;k++)
+        join(pairs[2*static_cast<size_t>(k)],pairs[2*static_cast<size_t>(k)+1]);
+    });
+}
+
+int ConcurrentPartition::compact(const int nThreads) {
+  int n = getNumberOfElements();
+  int nR = Parallel::getNumberOfRanges(nThreads,n);
+  // 1) count the roots in each range of elements
+  vector<int> nRoots(nR,0);
+  Parallel::forRanges(nThreads,n,[&](int k, int i0, int i1) {
+      for(int i=i0;i<i1;i++)
+        if(_parent[i].load(memory_order_relaxed)==i) nRoots[k]++;
+    });
+  int nParts = 0;
+  for(int k=0;k<nR;k++) {
+    int nk = nRoots[k]; nRoots[k] = nParts; nParts += nk;
+  }
+  // 2) number the roots consecutively
+  _part.resize(n);
+  Parallel::forRanges(nThreads,n,[&](int k, int i0, int i1) {
+      int iPart = nRoots[k];
+      for(int i=i0;i<i1;i++)
+        if(_parent[i].load(memory_order_relaxed)==i) _part[i] = iPart++;
+    });
+  // 3) label every other element with the ID of its root; the roots
+  //    are not modified in this step
+  Parallel::forRanges(nThreads,n,[&](int /*k*/, int i0, int i1) {
+      for(int i=i0,R;i<i1;i++)
+        if((R=find(i))!=i) _part[i] = _part[R];
+    });
+  return nParts;
+}
+
+int ConcurrentPartition::getPart(const int i) const {
+  return (i<0 || i>=static_cast<int>(_part.size()))?-1:_part[i];
+}
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// ConcurrentPartition.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _CONCURRENT_PARTITION_HPP_
+#define _CONCURRENT_PARTITION_HPP_
+
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+class ConcurrentPartition {
+
+  // this class implements a lock-free version of the Union-Find data
+  // structure, where find() and join() can be called concurrently
+  // from multiple threads
+  //
+  // - join() links the root with the larger index to the root with
+  //   the smaller index using an atomic compare-and-swap; as a
+  //   result the root of each part is its smallest element, and the
+  //   final partition and part IDs do not depend on the order in
+  //   which the join operations are applied
+  // - find() uses path halving; it never blocks
+  //
+  // Reference
+  // https://en.wikipedia.org/wiki/Disjoint-set_data_structure
+  
+public:
+
+  // create a partition of the N elements {0,1,2,...,N-1} where
+  // every element is a singleton {0},{1},{2},...,{N-1}
+          ConcurrentPartition(const int nElements);
+
+  // delete the current partition and create a new partition of the N
+  // elements {0,1,2,...,N-1} where every element is a singleton; not
+  // thread safe
+  void    reset(const int nElements);
+
+  // returns the current number of elements
+  int     getNumberOfElements()          const;
+
+  // returns the current number of parts
+  int     getNumberOfParts()             const;
+
+  // returns the part ID of the part containing element i, which is
+  // the smallest element of the part; if the element index is out of
+  // range this method returns -1
+  int     find(const int i);
+
+  // joins the parts containing elements i and j, and returns the ID of
+  // the resulting part; if either one of the two element indices is
+  // out of range this method returns -1; when other threads are
+  // joining parts concurrently, the returned ID may already be
+  // obsolete when this method returns
+  int     join(const int i, const int j);
+
+  // joins the pairs of elements (pairs[2*k],pairs[2*k+1]) using
+  // nThreads threads, or all the available cores if nThreads<=0;
+  // pairs with an out of range element, such as -1, are ignored
+  void    joinAll(const vector<int>& pairs, const int nThreads=1);
+
+  // relabels the parts with dense IDs 0<=iPart<getNumberOfParts(),
+  // in increasing order of their smallest elements, and returns the
+  // number of parts; should be called after all the join operations
+  // have finished
+  int     compact(const int nThreads=1);
+
+  // after compact() has been called, returns the dense ID of the part
+  // containing element i; otherwise, or if the element index is out
+  // of range, it returns -1
+  int     getPart(const int i)           const;
+
+private:
+
+  atomic<int>         _nParts;
+  vector<atomic<int>> _parent;
+  vector<int>         _part;
+
+};
+
+#endif /* _CONCURRENT_PARTITION_HPP_ */
@@ -41,6 +41,16 @@
 
 #include <math.h>
 #include "Edges.hpp"
+#include <util/Parallel.hpp>
+
+// exclusive prefix sum of the per-range counts; returns the total
+static int _prefixSum(vector<int>& count) {
+  int sum = 0;
+  for(size_t k=0;k<count.size();k++) {
+    int c = count[k]; count[k] = sum; sum += c;
+  }
+  return sum;
+}
 
 // public methods
 
@@ -122,3 +132,95 @@ int Edges::_insertEdge(int iV0, int iV1) {
   // return the index of the new edge
   return iE;
 }
+
+void Edges::_insertEdges(const vector<int>& coordIndex,
+                         vector<int>& cornerEdge,
+                         vector<int>& edgeFirstCorner,
+                         vector<int>& edgeCorner,
+                         const int nThreads) {
+  int nV = getNumberOfVertices();
+  int nC = static_cast<int>(coordIndex.size());
+  _reset(nV);
+  cornerEdge.assign(nC,-1);
+  int nR = Parallel::getNumberOfRanges(nThreads,nC);
+  vector<int> count(nR,0);
+
+  // 1) pack each valid half edge (iC,next(iC)) as a (iV0,iV1) key,
+  //    with iV0<iV1, using nBits bits for each vertex index, so that
+  //    the sort only processes the significant bits; each range of corners is processed twice, first
+  //    to count the valid half edges, and then to store their keys
+  //    after those of the previous ranges
+  int nBits = 1;
+  while(nBits<31 && (1<<nBits)<nV) nBits++;
+  auto halfEdge = [&](int iC, int iC0, int& iV0, int& iV1) {
+    iV0 = coordIndex[iC];
+    iV1 = (iC+1<nC && coordIndex[iC+1]>=0)?coordIndex[iC+1]:coordIndex[iC0];
+    if(iV0<0 || iV0==iV1 || nV<=iV0 || iV1<0 || nV<=iV1) return false;
+    if(iV0>iV1) { int iV=iV0; iV0=iV1; iV1=iV; }
+    return true;
+  };
+  auto faceStart = [&](int iC) {
+    while(iC>0 && coordIndex[iC-1]>=0) iC--;
+    return iC;
+  };
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      int iV0,iV1;
+      for(int iC0=faceStart(i0),iC=i0;iC<i1;iC++)
+        if(coordIndex[iC]<0) iC0 = iC+1;
+        else if(halfEdge(iC,iC0,iV0,iV1)) count[k]++;
+    });
+  int nH = _prefixSum(count);
+  vector<uint64_t> key(nH);
+  edgeCorner.resize(nH);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      int iV0,iV1,h = count[k];
+      for(int iC0=faceStart(i0),iC=i0;iC<i1;iC++)
+        if(coordIndex[iC]<0) {
+          iC0 = iC+1;
+        } else if(halfEdge(iC,iC0,iV0,iV1)) {
+          key[h] = (static_cast<uint64_t>(iV0)<<nBits)|static_cast<uint64_t>(iV1);
+          edgeCorner[h++] = iC;
+        }
+    });
+
+  // 2) sort the keys; since the corners were stored in increasing
+  //    order and the sort is stable, the corners incident to each
+  //    edge remain sorted
+  Parallel::radixSort(key,edgeCorner,2*nBits,nThreads);
+
+  // 3) create a new edge for each distinct key; the edge indices are
+  //    assigned by counting the distinct keys in each range of
+  //    sorted keys
+  nR = Parallel::getNumberOfRanges(nThreads,nH);
+  count.assign(nR,0);
+  Parallel::forRanges(nThreads,nH,[&](int k, int h0, int h1) {
+      for(int h=h0;h<h1;h++)
+        if(h==0 || key[h]!=key[h-1]) count[k]++;
+    });
+  int nE = _prefixSum(count);
+  _edge.resize(3*nE);
+  edgeFirstCorner.resize(nE+1);
+  edgeFirstCorner[nE] = nH;
+  Parallel::forRanges(nThreads,nH,[&](int k, int h0, int h1) {
+      int iE = count[k]-1;
+      for(int h=h0;h<h1;h++) {
+        if(h==0 || key[h]!=key[h-1]) {
+          iE++;
+          _edge[3*iE  ] = static_cast<int>(key[h]>>nBits);
+          _edge[3*iE+1] = static_cast<int>(key[h]&((uint64_t(1)<<nBits)-1));
+          edgeFirstCorner[iE] = h;
+        }
+        cornerEdge[edgeCorner[h]] = iE;
+      }
+    });
+
+  // 4) since the edges are sorted, the edges (iV0,*) are consecutive;
+  //    link each edge to the next one with the same first vertex
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0;iE<e1;iE++) {
+        int iV0 = _edge[3*iE];
+        _edge[3*iE+2] = (iE+1<nE && _edge[3*iE+3]==iV0)?3*iE+3:-1;
+        if(iE==0 || _edge[3*iE-3]!=iV0) _first[iV0] = 3*iE;
+      }
+    });
+}
@@ -43,6 +43,7 @@
 #define _EDGES_HPP_
 
 #include <vector>
+#include <cstdint>
 
 using namespace std;
 
@@ -104,6 +105,27 @@ protected:
   //   _isertEdge() returns the new index iE
   int     _insertEdge(const int iV0, const int iV1);
 
+  // - bulk construction of the edges of a polygon mesh; all the
+  //   previously inserted edges are removed, and the edges defined by
+  //   consecutive corners of the faces described by coordIndex are
+  //   inserted; the number of vertices is not changed
+  // - each half edge is packed as a 64 bit (min,max) key, the keys
+  //   are radix sorted, and the edges are created in a single pass
+  //   over the sorted keys; as a result edges are numbered in
+  //   lexicographic order of (iV0,iV1)
+  // - on return cornerEdge[iC] is the index of the edge of the half
+  //   edge starting at corner iC, or -1 if iC is a face separator or
+  //   it defines an invalid edge; the corners incident to edge iE are
+  //   stored in increasing order in edgeCorner[k], for
+  //   edgeFirstCorner[iE]<=k<edgeFirstCorner[iE+1]
+  // - the work is split among nThreads threads (all the available
+  //   cores if nThreads<=0); the result does not depend on nThreads
+  void    _insertEdges(const vector<int>& coordIndex,
+                       vector<int>& cornerEdge,
+                       vector<int>& edgeFirstCorner,
+                       vector<int>& edgeCorner,
+                       const int nThreads=1);
+
 private:
 
   // representation: array of single-linked lists
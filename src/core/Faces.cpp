@@ -37,72 +37,74 @@
 #include <math.h>
 #include "Faces.hpp"
 
-Faces::Faces(const int nV, const vector<int>& coordIndex) {
-    // TODO agregar chequeos
-    this->nV = nV;
-    this->coordIndex = coordIndex;
-    this->firstCornerFace.push_back(0);
-    uint faceIndex = 0;
-    for (uint i = 0; i < coordIndex.size(); ++i){
-        if(coordIndex[i] == -1){
-            this->firstCornerFace.push_back(i+1);
-            this->coordIndex[i] *= ++faceIndex;
+Faces::Faces(const int nV, const vector<int>& coordIndex):
+    _nV((nV>0)?nV:0),
+    _coordIndex(coordIndex),
+    _firstCornerFace(),
+    _cornerFace() {
+    int nC = static_cast<int>(_coordIndex.size());
+    _cornerFace.resize(nC,-1);
+    _firstCornerFace.push_back(0);
+    int iF = 0;
+    for (int iC = 0; iC < nC; ++iC){
+        int iV = _coordIndex[iC];
+        if(iV < 0){
+            // face separator
+            _firstCornerFace.push_back(iC+1);
+            ++iF;
+        } else {
+            _cornerFace[iC] = iF;
+            if(iV >= _nV) _nV = iV+1;
         }
     }
+    // if the last face is not terminated by a -1 separator, a virtual
+    // separator is assumed at the end of the coordIndex array
+    if(nC > 0 && _coordIndex[nC-1] >= 0)
+        _firstCornerFace.push_back(nC+1);
 }
 
 int Faces::getNumberOfVertices() const {
-    return  this->nV;
+    return _nV;
 }
 
 int Faces::getNumberOfFaces() const {
-    return this->firstCornerFace.size() - 1;
+    return static_cast<int>(_firstCornerFace.size()) - 1;
 }
 
 int Faces::getNumberOfCorners() const {
-    return this->coordIndex.size();
+    return static_cast<int>(_coordIndex.size());
 }
 
-
 int Faces::getFaceSize(const int iF) const {
-
-    int size = -1;
-    if(iF < this->getNumberOfFaces())
-        while(this->coordIndex[this->firstCornerFace[iF] + (++size)] > -1);
-    return size;
+    if(iF < 0 || iF >= getNumberOfFaces()) return 0;
+    return _firstCornerFace[iF+1] - _firstCornerFace[iF] - 1;
 }
 
 int Faces::getFaceFirstCorner(const int iF) const {
-    int firstCorner = -1;
-    if(iF < this->getNumberOfFaces())
-        firstCorner = this->firstCornerFace[iF];
-    return firstCorner;
+    if(iF < 0 || iF >= getNumberOfFaces()) return -1;
+    return _firstCornerFace[iF];
 }
 
 int Faces::getFaceVertex(const int iF, const int j) const {
-    int vertex = -1;
-    if(iF < this->getNumberOfFaces() && j < this->getFaceSize(iF))
-        vertex = this->coordIndex[this->getFaceFirstCorner(iF) + j];
-    return vertex;
+    if(j < 0 || j >= getFaceSize(iF)) return -1;
+    return _coordIndex[_firstCornerFace[iF] + j];
 }
 
 int Faces::getCornerFace(const int iC) const {
-    if (iC >= this->getNumberOfCorners()) // refactor
-        return -1;
-    int i = -1;
-    int face = 0;
-    while((face = this->coordIndex[iC + (++i)]) > 0);
-    face = i == 0 ? -1 : -1*face - 1;
-    return face;
+    if(iC < 0 || iC >= getNumberOfCorners()) return -1;
+    return _cornerFace[iC];
 }
 
 int Faces::getNextCorner(const int iC) const {
-    if (iC >= this->getNumberOfCorners()) // refactor
-        return -1;
-    int nextCoord = -1;
-    if(this->coordIndex[iC] > 0)
-        if((nextCoord = this->coordIndex[iC+1]) < 0)
-            nextCoord = this->getFaceFirstCorner(-1*nextCoord - 1);
-    return nextCoord;
+    int iF = getCornerFace(iC);
+    if(iF < 0) return -1;
+    int iC0 = _firstCornerFace[iF];
+    return (iC+1 < _firstCornerFace[iF+1]-1) ? iC+1 : iC0;
 }
 
+int Faces::getPrevCorner(const int iC) const {
+    int iF = getCornerFace(iC);
+    if(iF < 0) return -1;
+    int iC0 = _firstCornerFace[iF];
+    return (iC > iC0) ? iC-1 : _firstCornerFace[iF+1]-2;
+}
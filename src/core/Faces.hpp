@@ -45,6 +45,10 @@ using namespace std;
 class Faces {
 
 public:
+    // The Faces object keeps a reference to the coordIndex array, which
+    // should not be modified or destroyed while the Faces object is in
+    // use. The navigation tables are built in the constructor in linear
+    // time, so that all the query methods run in constant time.
     Faces(const int nV, const vector<int>& coordIndex);
 
     // The constructor should compare the nV value passed as a parameter
@@ -89,12 +93,23 @@ public:
     // corner. Otherwise it returns -1.
     int     getNextCorner(const int iC)              const;
 
+    // If iC is a valid corner index, and it does not correspond to a -1
+    // separator, this method returns the previous corner index within
+    // the cyclical order of the face which contains the given
+    // corner. Otherwise it returns -1.
+    int     getPrevCorner(const int iC)              const;
+
 private:
 
-    // TODO
-    uint nV;
-    vector<int> coordIndex;
-    vector<int> firstCornerFace;
+    int                _nV;
+    // reference to the coordIndex passed as argument
+    const vector<int>& _coordIndex;
+    // CSR face table: the corners of face iF are the indices
+    // _firstCornerFace[iF]<=iC<_firstCornerFace[iF+1]-1, and
+    // _firstCornerFace[iF+1]-1 is the face separator
+    vector<int>        _firstCornerFace;
+    // mapping from corners to faces; -1 for face separators
+    vector<int>        _cornerFace;
 };
 
 #endif /* _FACES_HPP_ */
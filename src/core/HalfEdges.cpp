@@ -45,156 +45,112 @@
 #include "HalfEdges.hpp"
 #include "Graph.hpp"
 #include <io/StrException.hpp>
+#include <util/Parallel.hpp>
 #include <iostream>
 
 
 // 1) all half edges corresponding to regular mesh edges are made twins
 // 2) all the other edges are made boundary half edges (twin==-1)
 
-HalfEdges::HalfEdges(const int nVertices, const vector<int>&  coordIndex):
+HalfEdges::HalfEdges
+(const int nVertices, const vector<int>&  coordIndex, const int nThreads):
   Edges(nVertices), // a graph with no edges is created here
   _coordIndex(coordIndex),
+  _nFaces(0),
   _twin(),
   _face(),
   _firstCornerEdge(),
-  _cornerEdge()
+  _cornerEdge(),
+  _halfEdgeEdge(),
+  _next(),
+  _prev()
 {
-  // TODO
-
-  // - both the _twin array and the _face array should end up being of
-  //   the same size as the _coordIndex array
-  // - for each corner index iC contained in face iF
-  // - the half edge src is iC, and the half edge dst is iC+1 if iC is
-  //   not the last corner of the face; otherwise is iC0
-  //
-  //   if _coordIndex[iC]>=0 then
-  //     _face[iC] should be equal to iF
-  //     if 
-  //     _twin[iC] should be equal to the corner index of the twin half edge 
-  //   if _coordIndex[iC]<0 then
-  //   _face[
-  
   int nV = nVertices;
   int nC = static_cast<int>(_coordIndex.size()); // number of corners
+  int nR = Parallel::getNumberOfRanges(nThreads,nC);
 
   // 0) just to be safe, verify that for each corner iC that
-  //    -1<=iV && iV<nV, where iV=coordIndex[iC]
-  //
-  //    if you find a violation, you can increment and the variable
-  //    nV, and then use the method Edges::_reset() to adjust the
-  //    number of vertices of the graph, if necessary; or you can
-  //    abort throwing an StrException
-  
-  for(uint iC=0;iC<_coordIndex.size();++iC)
-      if(!(_coordIndex[iC] >= -1 && _coordIndex[iC] < nV))
-        throw new StrException("Bad coordIndex");
-
-  // 1) create an empty vector<int> to count the number of incident
-  //    faces per edge; size is not known at this point because the
-  //    edges have not been created yet
-  vector<int> nFacesEdge;
-
-  // 2) insert all the edges in the graph; at the same time initialize
-  //    the _twin array so that all the half edges are boundary, count
-  //    the number of incident faces per edge and fill the _face aray
-  int iV0,iV1,iF,iE,iC,iC0,iC1,nextiC;
-  for(iF=iC0=iC1=0;iC1<nC;iC1++) {
-    //if(_coordIndex[iC1]>=0) continue;
-    // face iF comprises corners iC0<=iC<iC1
-    // - each corner in this range corresponds to one half edge
-    iC = iC0;
-    while(_coordIndex[iC] > -1){
-
-        // - find the next corner within the face
-        // - get the two vertex indices and insert an edge in the graph if
-        //   not already there
-        if(_coordIndex[iC+1] == -1)
-            nextiC = iC0;
-        else
-            nextiC = iC + 1;
-        iV0 = min(_coordIndex[iC],_coordIndex[nextiC]);
-        iV1 = max(_coordIndex[iC],_coordIndex[nextiC]);
-
-        // - note that Edges::_insertEdge return the edge index number of
-        //   a newly created edge, or the index of an extisting edge
-        iE = _insertEdge(iV0,iV1);
-
-        // - note that iE might be >= nFacesEdge.size() at this point, and
-        //   you may need to increase the size of nFacesEdge first
-        if (iE >= static_cast<int>(nFacesEdge.size()))
-            nFacesEdge.push_back(1); // boundary edge
-        else
-            ++nFacesEdge[iE];
-
-        //fill the _face aray and default initialize _twin
-        iC1 = iC + 1;
-        _face.push_back(iF);
-        _twin.push_back(-1);
-        ++iC;
-    }
-    _face.push_back(-1);
-    _twin.push_back(-(iC1 - iC0));
-    // increment variables to continue processing next face
-    iC0 = iC1 + 1;
-    iF++;
+  //    -1<=iV && iV<nV, where iV=coordIndex[iC]; at the same time
+  //    count the number of faces ending in each range of corners
+  vector<int> nFacesRange(nR,0);
+  vector<char> badRange(nR,0);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      for(int iC=i0;iC<i1;++iC)
+        if(!(_coordIndex[iC] >= -1 && _coordIndex[iC] < nV))
+          badRange[k] = 1;
+        else if(_coordIndex[iC]<0)
+          nFacesRange[k]++;
+    });
+  for(int k=0;k<nR;k++)
+    if(badRange[k])
+      throw new StrException("Bad coordIndex");
+  for(int k=0;k<nR;k++) {
+    int n = nFacesRange[k]; nFacesRange[k] = _nFaces; _nFaces += n;
   }
 
-  // 3) create an array to hold the first twin corner for each edge
-  // - the size of this array should be equal to the number of edges
-  // - initialize it with -1's
-  int nF = iF;
-  int nE = getNumberOfEdges();
-  vector<int> twinCorner(nE, -1);
-
-  // 4) fill the _twin array
-  // - visit all the half edges using a loop similar to the one used in step 2)
-  int src; int dst;
-  for(iC=0;iC<nC;++iC) {
-    // - for each half edge iC, get the src and dst vertex indices, and
-    //   from them the index iE of the corresponding edge
-    // - if twinCorner[iE]<1 save iC in twinCorner[iE]
-    //   otherwise save the value stored in twinCorner[iE] in _twin[iC]
-    //   and iC in _twin[_twin[iC]]
-    if((src = getSrc(iC)) >= 0 && (dst = getDst(iC)) && (iE = getEdge(src, dst))){
-        if(twinCorner[iE] < 0)
-            twinCorner[iE] = iC;
-        else{
-            _twin[iC] = twinCorner[iE];
-            _twin[_twin[iC]] = iC;
+  // 1) fill the _face array, and initialize the _twin array so that
+  //    all the half edges are boundary; the face separators store
+  //    -1 in the _face array, and minus the face size in the _twin
+  //    array
+  _face.resize(nC,-1);
+  _twin.resize(nC,-1);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      int iF = nFacesRange[k];
+      int iC0 = i0;
+      while(iC0>0 && _coordIndex[iC0-1]>=0) iC0--;
+      for(int iC=i0;iC<i1;iC++) {
+        if(_coordIndex[iC]>=0) {
+          _face[iC] = iF;
+        } else {
+          _twin[iC] = -(iC-iC0);
+          iC0 = iC+1;
+          iF++;
         }
-    }
-    // for the moment let's assume that the mesh does not have singular edges
-    // (i.e. we do not have to check for orientation here);
-  }
+      }
+    });
 
+  // 2) insert all the edges in the graph in bulk; this also fills the
+  //    half edge to edge map, and the array of arrays representing
+  //    the edge to half-edge incidence relationships, with the
+  //    corners incident to each edge in increasing order
+  _insertEdges(_coordIndex,_halfEdgeEdge,_firstCornerEdge,_cornerEdge,
+               nThreads);
 
-  // 5) initialize the array of arrays representing the half-edge to
-  //    edge incident relationships
-  //    _firstCornerEdge, and _cornerEdge
-  //    - the size of _firstCornerEdge should be equal to nE+1
-  //    - the size of _cornerEdge should be equal to the number of valid corners
-  //      nC-nF
-  //    - set boundaries
-  //      _firstCornerEdge[0]=0
-  //      _firstCornerEdge[iE+1] = _firstCornerEdge[iE]+nFacesEdge[iE] (1<=iE<nE)
-  _cornerEdge.resize(nC-nF,-1);
-  _firstCornerEdge.resize(nE+1, 0);
-  _firstCornerEdge[0] = 0;
-  for(iE=0;iE<nE;++iE)
-      _firstCornerEdge[iE + 1] = _firstCornerEdge[iE] + nFacesEdge[iE];
+  // 3) fill the _twin array; only the two half edges incident to a
+  //    regular edge are made twins
+  int nE = getNumberOfEdges();
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0,j;iE<e1;iE++) {
+        if(_firstCornerEdge[iE+1]-(j=_firstCornerEdge[iE])!=2) continue;
+        _twin[_cornerEdge[j  ]] = _cornerEdge[j+1];
+        _twin[_cornerEdge[j+1]] = _cornerEdge[j  ];
+      }
+    });
+}
 
-  // 6) fill the array of arrays - the indices of corners incident to
-  //    edge iE (1 if boundary, 2 if regular, >2 if singular) should
-  //    be stored consecutively in _cornerEdge starting at the
-  //    location _firstCornerEdge[iE]
-  for(iC=0;iC<nC;++iC){
-        if((src = getSrc(iC)) == -1 || (dst = getDst(iC)) == -1) continue;
-        int start = _firstCornerEdge[getEdge(src, dst)];
-        while(_cornerEdge[start] != -1)++start;
-        _cornerEdge[start] = iC;
-  }
+
+void HalfEdges::buildNavigation(const int nThreads) {
+  int nC = static_cast<int>(_coordIndex.size());
+  _next.assign(nC,-1);
+  _prev.assign(nC,-1);
+  // the face separators store minus the face size in the _twin array,
+  // so that each range of corners can locate the beginning of every
+  // face that ends within the range
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int iC=i0;iC<i1;iC++) {
+        if(_coordIndex[iC]>=0) continue;
+        int n = -_twin[iC], iC0 = iC-n;
+        for(int j=0;j<n;j++) {
+          _next[iC0+j] = iC0+(j+1)%n;
+          _prev[iC0+j] = iC0+(j+n-1)%n;
+        }
+      }
+    });
 }
 
+bool HalfEdges::hasNavigation() const {
+  return !_next.empty() || _coordIndex.empty();
+}
 
 bool HalfEdges::isValidCoord(const int iC) const{
     return (iC >= 0 && iC < static_cast<int>(_coordIndex.size()) && _coordIndex[iC] >= 0);
@@ -210,6 +166,10 @@ int HalfEdges::getNumberOfCorners() {
   return static_cast<int>(_coordIndex.size());
 }
 
+int HalfEdges::getNumberOfFaces() const {
+  return _nFaces;
+}
+
 // in all subsequent methods check that the arguments are valid, and
 // return -1 if any argument is out of range
 
@@ -231,7 +191,9 @@ int HalfEdges::getSrc(const int iC) const {
 // half-edge method dstVertex()
 int HalfEdges::getDst(const int ic) const {
     int dst = -1; uint iC = ic;
-    if(isValidCoord(iC))
+    if(!_next.empty())
+        dst = isValidCoord(ic) ? _coordIndex[_next[ic]] : -1;
+    else if(isValidCoord(iC))
         if((dst = _coordIndex[++iC]) < 0)
             dst = _coordIndex[iC + _twin[iC]];
     return dst;
@@ -242,7 +204,9 @@ int HalfEdges::getNext(const int ic) const {
   // if iC is the last corner of its face, use the face size
   // stored in _twin[iC+1] to locate the first corner of the face
   int next = -1; uint iC = ic;
-  if(isValidCoord(iC))
+  if(!_next.empty())
+      next = isValidCoord(ic) ? _next[ic] : -1;
+  else if(isValidCoord(iC))
       if((next = ++iC) && (_coordIndex[next] < 0))
           next = iC + _twin[iC] ;
   return next;
@@ -257,12 +221,20 @@ int HalfEdges::getPrev(const int ic) const {
   // the fact that all the faces have at least 3 corners to start the
   // search for the face separator at iC+3
   int prev = -1; uint iC = ic;
-  if(isValidCoord(iC))
+  if(!_prev.empty())
+      prev = isValidCoord(ic) ? _prev[ic] : -1;
+  else if(isValidCoord(iC))
       if((prev = --iC) && (prev == -1 || _coordIndex[prev] < 0) && (prev += 3))
           while((_coordIndex[prev+1] >= 0) && ++prev);
   return prev;
 }
 
+int HalfEdges::getHalfEdgeEdge(const int iC) const {
+    int iE = -1;
+    if(isValidCoord(iC)) iE = _halfEdgeEdge[iC];
+    return iE;
+}
+
 int HalfEdges::getTwin(const int iC) const {
     int twin = -1;
     if(isValidCoord(iC)) twin = _twin[iC];
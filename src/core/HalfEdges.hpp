@@ -61,14 +61,22 @@ public:
   // int     getVertex0(const int iE)                  const;
   // int     getVertex1(const int iE)                  const;
 
-  // constructor performs most of the work
+  // constructor performs most of the work; the work is split among
+  // nThreads threads, or all the available cores if nThreads<=0; the
+  // resulting data structures do not depend on the number of threads
 
-          HalfEdges(const int nV, const vector<int>& coordIndex);
+          HalfEdges(const int nV, const vector<int>& coordIndex,
+                    const int nThreads=1);
 
   // returns the number of elements of the coordIndex array
 
   int     getNumberOfCorners();
 
+  // returns the number of faces, i.e. the number of -1's in the
+  // coordIndex array
+
+  int     getNumberOfFaces() const;
+
   // returns the index of the face containing the half edge
   // corresponding to the corner index iC; if the corner index is out
   // of range, or it corresponds to a face separator, this method
@@ -91,6 +99,15 @@ public:
   int     getNext(const int iC) const;
   int     getPrev(const int iC) const;
 
+  // optional navigation tables: packed arrays of next and previous
+  // corners, built in linear time; once built, getNext(), getPrev()
+  // and getDst() are constant time table lookups; otherwise getPrev()
+  // has to search forward for the end of the face; the tables use
+  // 2*nC additional integers
+
+  void    buildNavigation(const int nThreads=1);
+  bool    hasNavigation() const;
+
   // a regular edge of a mesh has exactly two incident half-edges; if
   // the half-edge associated with corner iC corresponds to a regular
   // edge of the mesh, this methods returns the other half edge;
@@ -98,6 +115,13 @@ public:
 
   int     getTwin(const int iC) const;
 
+  // returns the index of the edge associated with the half edge
+  // starting at corner iC, or -1 if iC is out of range or it
+  // corresponds to a face separator; this is equivalent to
+  // getEdge(getSrc(iC),getDst(iC)), but it does not require a search
+
+  int     getHalfEdgeEdge(const int iC) const;
+
   // if the edge index iE is in range, this method returns the number
   // of half edges incident to the given edge; otherwise it returns 0
                                    
@@ -122,6 +146,9 @@ protected:
   // - consider these private variables are just a hint
   // - feel free to use different private variables
 
+  // number of faces
+        int          _nFaces;
+
   // array of twin corners
         vector<int>  _twin;
 
@@ -133,6 +160,14 @@ protected:
         vector<int> _firstCornerEdge;
         vector<int> _cornerEdge;
 
+  // mapping from half edges (corners) to edges
+        vector<int> _halfEdgeEdge;
+
+  // optional navigation tables; empty until buildNavigation() is
+  // called; -1 for face separators
+        vector<int> _next;
+        vector<int> _prev;
+
 };
 
 #endif /* _HALF_EDGES_HPP_ */
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// OccupancyGrid.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <algorithm>
+#include <bitset>
+#include <numeric>
+#include "OccupancyGrid.hpp"
+#include <util/Parallel.hpp>
+
+// spreads the 10 lower bits of v, so that there are two zero bits
+// between consecutive bits
+static uint64_t _spreadBits(uint64_t v) {
+  v &= 0x3ff;
+  v = (v|(v<<16))&0x30000ff;
+  v = (v|(v<< 8))&0x300f00f;
+  v = (v|(v<< 4))&0x30c30c3;
+  v = (v|(v<< 2))&0x9249249;
+  return v;
+}
+
+// inverse of _spreadBits
+static int _compactBits(uint64_t v) {
+  v &= 0x9249249;
+  v = (v|(v>> 2))&0x30c30c3;
+  v = (v|(v>> 4))&0x300f00f;
+  v = (v|(v>> 8))&0x30000ff;
+  v = (v|(v>>16))&0x3ff;
+  return static_cast<int>(v);
+}
+
+static size_t _hash(const uint64_t key, const int shift) {
+  return static_cast<size_t>((key*0x9e3779b97f4a7c15ULL)>>shift);
+}
+
+uint64_t OccupancyGrid::getKey(const int ix, const int iy, const int iz) {
+  return _spreadBits(ix)|(_spreadBits(iy)<<1)|(_spreadBits(iz)<<2);
+}
+
+void OccupancyGrid::getCell(const uint64_t key, int& ix, int& iy, int& iz) {
+  ix = _compactBits(key   );
+  iy = _compactBits(key>>1);
+  iz = _compactBits(key>>2);
+}
+
+OccupancyGrid::OccupancyGrid(const int depth):
+  _depth((depth<0)?0:(depth>MAX_DEPTH)?MAX_DEPTH:depth),
+  _key(),
+  _table(),
+  _tableShift(64) {
+}
+
+int OccupancyGrid::getDepth() const {
+  return _depth;
+}
+
+int OccupancyGrid::getResolution() const {
+  return 1<<_depth;
+}
+
+void OccupancyGrid::setCells(vector<uint64_t>& keys, const int nThreads) {
+  if(keys.size()>1) {
+    vector<int> val(keys.size());
+    iota(val.begin(),val.end(),0);
+    Parallel::radixSort(keys,val,max(1,3*_depth),nThreads);
+    keys.erase(unique(keys.begin(),keys.end()),keys.end());
+  }
+  _key = keys;
+
+  _brickKey.clear();
+  _brickMask.clear();
+  _brickFirst.clear();
+  int nCells = getNumberOfCells();
+  for(int iCell=0;iCell<nCells;iCell++) {
+    uint64_t brickKey = _key[iCell]>>6;
+    if(_brickKey.empty() || _brickKey.back()!=brickKey) {
+      _brickKey.push_back(brickKey);
+      _brickMask.push_back(0);
+      _brickFirst.push_back(iCell);
+    }
+    _brickMask.back() |= static_cast<uint64_t>(1)<<(_key[iCell]&63);
+  }
+
+  // the table has at least twice as many slots as bricks
+  int nBits = 1;
+  while((static_cast<size_t>(1)<<nBits)<2*_brickKey.size()) nBits++;
+  _tableShift = 64-nBits;
+  _table.assign(static_cast<size_t>(1)<<nBits,-1);
+  size_t tableMask = _table.size()-1;
+  int nBricks = static_cast<int>(_brickKey.size());
+  for(int iBrick=0;iBrick<nBricks;iBrick++) {
+    size_t h = _hash(_brickKey[iBrick],_tableShift);
+    while(_table[h]>=0) h = (h+1)&tableMask;
+    _table[h] = iBrick;
+  }
+}
+
+int OccupancyGrid::getNumberOfCells() const {
+  return static_cast<int>(_key.size());
+}
+
+uint64_t OccupancyGrid::getKey(const int iCell) const {
+  return _key[iCell];
+}
+
+void OccupancyGrid::getCell
+(const int iCell, int& ix, int& iy, int& iz) const {
+  getCell(_key[iCell],ix,iy,iz);
+}
+
+int OccupancyGrid::_findBrick(const uint64_t brickKey) const {
+  size_t tableMask = _table.size()-1;
+  size_t h = _hash(brickKey,_tableShift);
+  int iBrick;
+  while((iBrick=_table[h])>=0) {
+    if(_brickKey[iBrick]==brickKey) return iBrick;
+    h = (h+1)&tableMask;
+  }
+  return -1;
+}
+
+int OccupancyGrid::_findInBrick(const int iBrick, const uint64_t key) const {
+  if(iBrick<0) return -1;
+  uint64_t bit  = static_cast<uint64_t>(1)<<(key&63);
+  uint64_t mask = _brickMask[iBrick];
+  if((mask&bit)==0) return -1;
+  return _brickFirst[iBrick]+static_cast<int>(bitset<64>(mask&(bit-1)).count());
+}
+
+int OccupancyGrid::find(const int ix, const int iy, const int iz) const {
+  int N = getResolution();
+  if(ix<0 || ix>=N || iy<0 || iy>=N || iz<0 || iz>=N || _key.empty())
+    return -1;
+  uint64_t key = getKey(ix,iy,iz);
+  return _findInBrick(_findBrick(key>>6),key);
+}
+
+void OccupancyGrid::getNeighbors(const int iCell, int nb[27]) const {
+  int N = getResolution();
+  int ix,iy,iz,dx,dy,dz,s=0;
+  getCell(iCell,ix,iy,iz);
+  // the 27 neighbors span at most 8 bricks
+  uint64_t brickKey[8];
+  int      brick[8];
+  int      nBricks = 0;
+  for(dz=-1;dz<=1;dz++) {
+    for(dy=-1;dy<=1;dy++) {
+      for(dx=-1;dx<=1;dx++,s++) {
+        int jx = ix+dx, jy = iy+dy, jz = iz+dz;
+        if(jx<0 || jx>=N || jy<0 || jy>=N || jz<0 || jz>=N) {
+          nb[s] = -1;
+          continue;
+        }
+        uint64_t key = getKey(jx,jy,jz);
+        int b = 0;
+        while(b<nBricks && brickKey[b]!=(key>>6)) b++;
+        if(b==nBricks) {
+          brickKey[nBricks] = key>>6;
+          brick[nBricks++]  = _findBrick(key>>6);
+        }
+        nb[s] = _findInBrick(brick[b],key);
+      }
+    }
+  }
+}
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// OccupancyGrid.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _OCCUPANCY_GRID_HPP_
+#define _OCCUPANCY_GRID_HPP_
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+class OccupancyGrid {
+
+  // - sparse set of occupied cells of a regular grid of N=2^depth
+  //   cells per side, with 0<=depth<=10
+  // - each cell (ix,iy,iz) is identified by its Morton key, which
+  //   interleaves the bits of ix, iy, and iz; the occupied cells are
+  //   stored as a sorted array of distinct keys, which is the leaf
+  //   level of a pointer-free octree, and the memory used is
+  //   proportional to the number of occupied cells, rather than N^3
+  // - the cells are grouped in bricks of 4x4x4 cells, the groups of
+  //   64 consecutive keys; each non-empty brick stores a 64 bit mask
+  //   of its occupied cells, and the index of its first occupied cell,
+  //   and an open addressing hash table maps brick keys to bricks, so
+  //   that the occupied neighbors of a cell are found in constant
+  //   time, mostly within the same small set of bricks
+  // - cells are indexed 0<=iCell<getNumberOfCells(), in increasing
+  //   order of their keys
+
+public:
+
+  static const int MAX_DEPTH = 10;
+
+  static uint64_t getKey(const int ix, const int iy, const int iz);
+  static void     getCell(const uint64_t key, int& ix, int& iy, int& iz);
+
+                  OccupancyGrid(const int depth);
+
+  int             getDepth()                                        const;
+  int             getResolution()                                   const;
+
+  // replaces the occupied cells by those listed in keys, which may be
+  // unsorted and contain repetitions; keys is left sorted and without
+  // repetitions; the result does not depend on nThreads
+  void            setCells(vector<uint64_t>& keys, const int nThreads=1);
+
+  int             getNumberOfCells()                                const;
+  uint64_t        getKey(const int iCell)                           const;
+  void            getCell(const int iCell, int& ix, int& iy, int& iz) const;
+
+  // returns the index of the cell (ix,iy,iz) if it is occupied, and -1
+  // if it is not occupied or it is out of the grid
+  int             find(const int ix, const int iy, const int iz)    const;
+
+  // fills nb[(dx+1)+3*((dy+1)+3*(dz+1))] with find(ix+dx,iy+dy,iz+dz),
+  // for -1<=dx,dy,dz<=1, where (ix,iy,iz) is the cell iCell; the hash
+  // table is searched once per brick, rather than once per neighbor
+  void            getNeighbors(const int iCell, int nb[27])         const;
+
+private:
+
+  int             _findBrick(const uint64_t brickKey)               const;
+  int             _findInBrick(const int iBrick, const uint64_t key) const;
+
+  int              _depth;
+  vector<uint64_t> _key;
+  vector<uint64_t> _brickKey;
+  vector<uint64_t> _brickMask;
+  vector<int>      _brickFirst;
+  vector<int>      _table;
+  int              _tableShift;
+
+};
+
+#endif /* _OCCUPANCY_GRID_HPP_ */
@@ -40,88 +40,305 @@
 // DAMAGE.
 
 #include <iostream>
+#include <atomic>
+#include <algorithm>
 #include "PolygonMesh.hpp"
-#include "Partition.hpp"
+#include "ConcurrentPartition.hpp"
+#include <util/Parallel.hpp>
 
-PolygonMesh::PolygonMesh(const int nVertices, const vector<int>& coordIndex):
-  HalfEdges(nVertices,coordIndex),
+template<class HalfEdgesType>
+PolygonMeshT<HalfEdgesType>::PolygonMeshT
+(const int nVertices, const vector<int>& coordIndex, const int nThreads):
+  HalfEdgesType(nVertices,coordIndex,nThreads),
   _nPartsVertex(),
-  _isBoundaryVertex()
+  _isBoundaryVertex(),
+  _nComponents(0),
+  _faceComponent(),
+  _firstCornerVertex(),
+  _cornerVertex(),
+  _firstEdgeVertex(),
+  _edgeVertex()
 {
   int nV = getNumberOfVertices();
   int nE = getNumberOfEdges(); // Edges method
   int nC = getNumberOfCorners();
-  int iE;
-
-  // 1) classify the vertices as boundary or internal
   int iV;
-  for(iV=0;iV<nV;iV++)
-    _isBoundaryVertex.push_back(false);
 
+  // 1) classify the vertices as boundary or internal
   // - for edge boundary iE label its two end vertices as boundary
-
-  for(iE = 0; iE < nE; ++iE){
+  // - the labels are first stored in an array of atomic flags, so
+  //   that the edges can be processed in parallel
+  vector<atomic<bool>> isBoundaryVertex(nV);
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0;iE<e1;++iE){
         if(getNumberOfEdgeHalfEdges(iE) == 1){
-          _isBoundaryVertex[getVertex0(iE)] = true;
-          _isBoundaryVertex[getVertex1(iE)] = true;
+          isBoundaryVertex[getVertex0(iE)].store(true,memory_order_relaxed);
+          isBoundaryVertex[getVertex1(iE)].store(true,memory_order_relaxed);
         }
-  }
+      }
+    });
+  _isBoundaryVertex.resize(nV,false);
+  for(iV=0;iV<nV;iV++)
+    _isBoundaryVertex[iV] = isBoundaryVertex[iV].load(memory_order_relaxed);
   
   // 2) create a partition of the corners in the stack
-  Partition partition(nC);
+  ConcurrentPartition partition(nC);
 
   // 3) for each regular edge
-  int e1; int e2;
-  for(iE = 0; iE < nE; ++iE){
-      if(getNumberOfEdgeHalfEdges(iE) == 2){
-          //    - get the two half edges incident to the edge
-          //    - join the two pairs of corresponding corners accross the edge
-          //    - you need to take into account the relative orientation of
-          //      the two incident half edges
-          e1 = getEdgeHalfEdge(iE, 0);
-          e2 = getEdgeHalfEdge(iE, 1);
-          // for the moment let's assume that the mesh does not have
-          // singular edges, and that pairs of corners corresponding to the
-          // same vertex across inconsistently oriented faces will be joined
-          partition.join(e1,getNext(e2));
-          partition.join(e2,getNext(e1));
-
-          // note that the partition will end up with the corner separators as
-          // singletons, but it doesn't matter for the last step, and
-          // the partition will be deleteted upon return
-
+  //    - get the two half edges incident to the edge
+  //    - join the two pairs of corresponding corners accross the edge
+  //    - you need to take into account the relative orientation of
+  //      the two incident half edges
+  //    - the pairs of corners of edge iE are stored in
+  //      pairs[4*iE..4*iE+3], and -1's for edges which are not regular;
+  //      all the pairs are then joined in parallel
+  // for the moment let's assume that the mesh does not have
+  // singular edges, and that pairs of corners corresponding to the
+  // same vertex across inconsistently oriented faces will be joined
+  // note that the partition will end up with the corner separators as
+  // singletons, but it doesn't matter for the last step, and
+  // the partition will be deleteted upon return
+  vector<int> pairs(4*static_cast<size_t>(nE),-1);
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int i0, int i1) {
+      for(int iE=i0,e1,e2;iE<i1;++iE){
+        if(getNumberOfEdgeHalfEdges(iE) != 2) continue;
+        e1 = getEdgeHalfEdge(iE, 0);
+        e2 = getEdgeHalfEdge(iE, 1);
+        size_t j = 4*static_cast<size_t>(iE);
+        pairs[j  ] = e1; pairs[j+1] = getNext(e2);
+        pairs[j+2] = e2; pairs[j+3] = getNext(e1);
       }
-  }
+    });
+  partition.joinAll(pairs,nThreads);
   
   // 4) count number of parts per vertex
-  //   - initialize _nPartsVertex array to 0's
+  //    - a corner iC is the representative of its part if and only if
+  //      it is the root of the part
+  //    - get the corresponding vertex index iV and increment
+  //      _nPartsVertex[iV]
+  //    - note that all the corners in each subset share a common
+  //      vertex index, but multiple subsets may correspond to the
+  //      same vertex index, indicating that the vertex is singular
+  vector<atomic<int>> nPartsVertex(nV);
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int iC=i0;iC<i1;++iC)
+        if(_coordIndex[iC] >= 0 && partition.find(iC) == iC)
+          nPartsVertex[_coordIndex[iC]].fetch_add(1,memory_order_relaxed);
+    });
   _nPartsVertex.resize(nV,0);
-  //    - for each corner iC which is a representative of its subset
-  int pId;
-  vector<bool> visited(partition.getNumberOfParts(), false);
-  for(int iC = 0; iC < nC; ++iC)
-      if(_coordIndex[iC] >= 0 && (pId = partition.find(iC)) != -1)
-          if(!visited[pId]){
-             // - get the corresponding vertex index iV and increment _nPartsVertex[iV]
-             // - note that all the corners in each subset share a common
-            //  vertex index, but multiple subsets may correspond to the
-            //  same vertex index, indicating that the vertex is singular
-            _nPartsVertex[coordIndex[iC]]++;
-            visited[pId] = true;
-          }
+  for(iV=0;iV<nV;iV++)
+    _nPartsVertex[iV] = nPartsVertex[iV].load(memory_order_relaxed);
+
+  // 5) compute the connected components of the faces, by joining all
+  //    the faces incident to each edge; the nH-1 pairs of edge iE, with
+  //    nH half edges, are stored starting at 2*(_firstCornerEdge[iE]-iE)
+  int nF = getNumberOfFaces();
+  ConcurrentPartition components(nF);
+  pairs.assign(2*(_cornerEdge.size()-static_cast<size_t>(nE)),-1);
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0;iE<e1;++iE){
+        int j0 = _firstCornerEdge[iE];
+        int iF0 = getFace(_cornerEdge[j0]);
+        for(int j=j0+1;j<_firstCornerEdge[iE+1];j++) {
+          size_t k = 2*static_cast<size_t>(j-iE-1);
+          pairs[k  ] = iF0;
+          pairs[k+1] = getFace(_cornerEdge[j]);
+        }
+      }
+    });
+  components.joinAll(pairs,nThreads);
+  _nComponents = components.compact(nThreads);
+  _faceComponent.resize(nF);
+  Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+      for(int iF=f0;iF<f1;++iF)
+        _faceComponent[iF] = components.getPart(iF);
+    });
+}
+
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getNumberOfConnectedComponents() const {
+  return _nComponents;
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getFaceConnectedComponent(const int iF) const {
+  int nF = static_cast<int>(_faceComponent.size());
+  return (0<=iF && iF<nF)?_faceComponent[iF]:-1;
+}
+
+template<class HalfEdgesType>
+void PolygonMeshT<HalfEdgesType>::buildVertexStars(const int nThreads) {
+  int nV = getNumberOfVertices();
+  int nE = getNumberOfEdges();
+  int nC = getNumberOfCorners();
+  int nF = getNumberOfFaces();
+  int nBits = 1;
+  while(nBits<31 && (1<<nBits)<nV) nBits++;
+
+  // sorts the (vertex,element) pairs by vertex, and fills the first
+  // array so that the elements of vertex iV are stored in positions
+  // first[iV]<=k<first[iV+1] of the sorted element array
+  auto buildStars = [&](vector<uint64_t>& key, vector<int>& elem, vector<int>& first) {
+    Parallel::radixSort(key,elem,nBits,nThreads);
+    first.resize(nV+1);
+    Parallel::forRanges(nThreads,nV+1,[&](int /*k*/, int v0, int v1) {
+        for(int iV=v0;iV<v1;iV++)
+          first[iV] = static_cast<int>
+            (lower_bound(key.begin(),key.end(),static_cast<uint64_t>(iV))-key.begin());
+      });
+  };
+
+  // 1) corners; since the number of separators preceding corner iC is
+  //    equal to its face index, each valid corner iC is stored at
+  //    position iC-getFace(iC)
+  vector<uint64_t> key(nC-nF);
+  _cornerVertex.resize(nC-nF);
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int iC=i0,h;iC<i1;iC++) {
+        if(_coordIndex[iC]<0) continue;
+        h = iC-getFace(iC);
+        key[h] = static_cast<uint64_t>(_coordIndex[iC]);
+        _cornerVertex[h] = iC;
+      }
+    });
+  buildStars(key,_cornerVertex,_firstCornerVertex);
+
+  // 2) edges; each edge iE is stored twice, at positions 2*iE and
+  //    2*iE+1, once for each one of its ends
+  key.resize(2*static_cast<size_t>(nE));
+  _edgeVertex.resize(2*static_cast<size_t>(nE));
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0;iE<e1;iE++) {
+        size_t j = 2*static_cast<size_t>(iE);
+        key[j  ] = static_cast<uint64_t>(getVertex0(iE));
+        key[j+1] = static_cast<uint64_t>(getVertex1(iE));
+        _edgeVertex[j  ] = iE;
+        _edgeVertex[j+1] = iE;
+      }
+    });
+  buildStars(key,_edgeVertex,_firstEdgeVertex);
+}
+
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::hasVertexStars() const {
+  return !_firstCornerVertex.empty();
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getNumberOfVertexCorners(const int iV) const {
+  if(!hasVertexStars() || iV<0 || iV>=getNumberOfVertices()) return 0;
+  return _firstCornerVertex[iV+1]-_firstCornerVertex[iV];
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getVertexCorner(const int iV, const int j) const {
+  if(j<0 || j>=getNumberOfVertexCorners(iV)) return -1;
+  return _cornerVertex[_firstCornerVertex[iV]+j];
 }
 
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getVertexFace(const int iV, const int j) const {
+  return getFace(getVertexCorner(iV,j));
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getNumberOfVertexEdges(const int iV) const {
+  if(!hasVertexStars() || iV<0 || iV>=getNumberOfVertices()) return 0;
+  return _firstEdgeVertex[iV+1]-_firstEdgeVertex[iV];
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getVertexEdge(const int iV, const int j) const {
+  if(j<0 || j>=getNumberOfVertexEdges(iV)) return -1;
+  return _edgeVertex[_firstEdgeVertex[iV]+j];
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getVertexNeighbor(const int iV, const int j) const {
+  int iE = getVertexEdge(iV,j);
+  if(iE<0) return -1;
+  int iV0 = getVertex0(iE);
+  return (iV0==iV)?getVertex1(iE):iV0;
+}
 
-int PolygonMesh::getNumberOfFaces() const {
-    return _face[_face.size() - 2]  + 1;
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getNextCornerAroundVertex(const int iC) const {
+  int iV = getSrc(iC);
+  if(iV<0) return -1;
+  // the twin of the previous half edge ends at iV if the two faces are
+  // consistently oriented, and starts at iV otherwise
+  int iT = getTwin(getPrev(iC));
+  if(iT<0) return -1;
+  return (getSrc(iT)==iV)?iT:getNext(iT);
 }
 
-int PolygonMesh::getNumberOfEdgeFaces(const int iE) const {
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getPrevCornerAroundVertex(const int iC) const {
+  int iV = getSrc(iC);
+  if(iV<0) return -1;
+  int iT = getTwin(iC);
+  if(iT<0) return -1;
+  return (getSrc(iT)==iV)?iT:getNext(iT);
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getVertexCornerRotation
+(const int iV, vector<int>& corners) const {
+  corners.clear();
+  if(!hasVertexStars() || iV<0 || iV>=getNumberOfVertices()) return -1;
+  if(isSingularVertex(iV)) return -1;
+  int n = getNumberOfVertexCorners(iV);
+  if(n==0) return 0;
+
+  // each corner iC incident to iV has two edges incident to iV in its
+  // face, the edges of the half edges iC and getPrev(iC); moving to the
+  // next corner, the face is left across the edge which was not used
+  // to enter it, so that the direction of rotation is preserved across
+  // inconsistently oriented faces; returns the next corner, and
+  // updates iE with the edge crossed, or returns -1 at boundary and
+  // singular edges
+  auto rotate = [&](int iC, int& iE) {
+    int iH = (this->getHalfEdgeEdge(iC)==iE)?getPrev(iC):iC;
+    int iT = getTwin(iH);
+    if(iT<0) return -1;
+    iE = this->getHalfEdgeEdge(iH);
+    return (getSrc(iT)==iV)?iT:getNext(iT);
+  };
+
+  int k,iE,iC,iC0 = getVertexCorner(iV,0);
+
+  // for a boundary vertex, rotate backwards to the first corner of the
+  // fan; the loops are bounded in case the vertex has incident
+  // singular edges
+  if(isBoundaryVertex(iV)) {
+    iE = this->getHalfEdgeEdge(getPrev(iC0));
+    for(k=0;k<n && (iC=rotate(iC0,iE))>=0;k++)
+      iC0 = iC;
+    // the backward rotation stopped at the edge of iC0 which is not iE,
+    // and which is regarded as the entry edge of the forward rotation
+    iE = (iE==this->getHalfEdgeEdge(iC0))?
+      this->getHalfEdgeEdge(getPrev(iC0)):this->getHalfEdgeEdge(iC0);
+  } else {
+    iE = this->getHalfEdgeEdge(iC0);
+  }
+
+  iC = iC0;
+  do {
+    corners.push_back(iC);
+    iC = rotate(iC,iE);
+  } while(iC>=0 && iC!=iC0 && static_cast<int>(corners.size())<n);
+  return static_cast<int>(corners.size());
+}
+
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getNumberOfEdgeFaces(const int iE) const {
   return getNumberOfEdgeHalfEdges(iE);
 }
 
 
-int PolygonMesh::getEdgeFace(const int iE, const int j) const {
+template<class HalfEdgesType>
+int PolygonMeshT<HalfEdgesType>::getEdgeFace(const int iE, const int j) const {
     return getFace(getEdgeHalfEdge(iE, j));
 }
 // if the arguments fall within their respective ranges, this method
@@ -129,7 +346,8 @@ int PolygonMesh::getEdgeFace(const int iE, const int j) const {
 // to the edge iE; otherwise it returns false
 
 
-bool PolygonMesh::isEdgeFace(const int iE, const int iF) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isEdgeFace(const int iE, const int iF) const {
     if(iF >= 0 && iF < getNumberOfFaces())
         for(u_int i = 0; i < getNumberOfEdgeFaces(iE); ++i)
             if(getEdgeFace(iE, i) == iF)
@@ -139,33 +357,45 @@ bool PolygonMesh::isEdgeFace(const int iE, const int iF) const {
 
 // classification of edges
 
-bool PolygonMesh::isBoundaryEdge(const int iE) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isBoundaryEdge(const int iE) const {
     return isValidEdge(iE) && getNumberOfEdgeHalfEdges(iE) == 1;
 }
 
-bool PolygonMesh::isRegularEdge(const int iE) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isRegularEdge(const int iE) const {
   return isValidEdge(iE) && getNumberOfEdgeHalfEdges(iE) == 2;
 }
 
-bool PolygonMesh::isSingularEdge(const int iE) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isSingularEdge(const int iE) const {
     return isValidEdge(iE) && getNumberOfEdgeHalfEdges(iE) > 2;
 }
 
 // classification of vertices
 
-bool PolygonMesh::isBoundaryVertex(const int iV) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isBoundaryVertex(const int iV) const {
   int nV = getNumberOfVertices();
   return (0<=iV && iV<nV)?_isBoundaryVertex[iV]:false;
 }
 
-bool PolygonMesh::isSingularVertex(const int iV) const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isInternalVertex(const int iV) const {
+  int nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?!_isBoundaryVertex[iV]:false;
+}
+
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isSingularVertex(const int iV) const {
   int nV = getNumberOfVertices();
   return (0<=iV && iV<nV && _nPartsVertex[iV]>1);
 }
 
 // properties of the whole mesh
 
-bool PolygonMesh::isRegular() const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::isRegular() const {
     int iV = 0; int iE = 0;
     int nE = getNumberOfEdges();
     int nV = getNumberOfVertices();
@@ -176,8 +406,13 @@ bool PolygonMesh::isRegular() const {
     return true;
 }
 
-bool PolygonMesh::hasBoundary() const {
+template<class HalfEdgesType>
+bool PolygonMeshT<HalfEdgesType>::hasBoundary() const {
     int n = 0; int iE = 0; int nE = getNumberOfEdges();
     while((n+= isBoundaryEdge(iE++)) == 0 && iE < nE);
     return n > 0;
 }
+
+template class PolygonMeshT<HalfEdges>;
+template class PolygonMeshT<TriangleHalfEdges>;
+template class PolygonMeshT<QuadHalfEdges>;
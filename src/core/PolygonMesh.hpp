@@ -44,13 +44,35 @@
 
 #include <vector>
 #include "HalfEdges.hpp"
+#include "TriangleHalfEdges.hpp"
 
 using namespace std;
 
-class PolygonMesh : public HalfEdges {
+// PolygonMeshT can be built on top of HalfEdges, for arbitrary polygon
+// meshes, or on top of NgonHalfEdges<N>, for meshes where all the faces
+// have N corners; in both cases it exposes the same query interface;
+// see the typedefs at the end of this file
+
+template<class HalfEdgesType>
+class PolygonMeshT : public HalfEdgesType {
 
 public:
 
+  using HalfEdgesType::getNumberOfVertices;
+  using HalfEdgesType::getNumberOfEdges;
+  using HalfEdgesType::getVertex0;
+  using HalfEdgesType::getVertex1;
+  using HalfEdgesType::getNumberOfCorners;
+  using HalfEdgesType::getNumberOfFaces;
+  using HalfEdgesType::getFace;
+  using HalfEdgesType::getNext;
+  using HalfEdgesType::getPrev;
+  using HalfEdgesType::getTwin;
+  using HalfEdgesType::getSrc;
+  using HalfEdgesType::getNumberOfEdgeHalfEdges;
+  using HalfEdgesType::getEdgeHalfEdge;
+  using HalfEdgesType::isValidEdge;
+
   // inherits from Edges
   //
   // void    reset(const int nV);
@@ -63,20 +85,22 @@ public:
   // inherits from HalfEdges
   //
   // int     getNumberOfCorners();
+  // int     getNumberOfFaces()                        const;
   // int     getFace(const int iC) const;
   // int     getSrc(const int iC) const;
   // int     getDst(const int iC) const;
   // int     getNext(const int iC) const;
   // int     getPrev(const int iC) const;
   // int     getTwin(const int iC) const;
+  // int     getHalfEdgeEdge(const int iC) const;
   // int     getNumberOfEdgeHalfEdges(const int iE);
   // int     getEdgeHalfEdge(const int iE, const int j);
 
-             PolygonMesh(const int nV, const vector<int>& coordIndex);
-
-  // number of -1's in the coordIndex argument
+  // the work is split among nThreads threads, or all the available
+  // cores if nThreads<=0; the result does not depend on nThreads
 
-     int     getNumberOfFaces()                        const;
+             PolygonMeshT(const int nV, const vector<int>& coordIndex,
+                          const int nThreads=1);
 
   // number of faces incident to each edge; note that this is equal to
   // the number of half edges incident to each edge
@@ -164,7 +188,70 @@ public:
   // boundary edge
 
      bool    hasBoundary()                             const;
+
+  // two faces belong to the same connected component if they can be
+  // connected by a sequence of faces where consecutive faces share an
+  // edge; the connected components are numbered in increasing order
+  // of their smallest face index
+
+     int     getNumberOfConnectedComponents()          const;
+
+  // returns the connected component index of the face iF, or -1 if
+  // the face index is out of range
+
+     int     getFaceConnectedComponent(const int iF)   const;
+
+  // optional vertex star index: compressed arrays of arrays with the
+  // corners and the edges incident to each vertex, built in parallel
+  // in linear time; the query methods below return 0 or -1 until
+  // buildVertexStars() has been called
+
+     void    buildVertexStars(const int nThreads=1);
+     bool    hasVertexStars()                          const;
+
+  // corners (and faces) incident to vertex iV, in increasing order
+  // of corner index; 0<=j<getNumberOfVertexCorners(iV)
+
+     int     getNumberOfVertexCorners(const int iV)    const;
+     int     getVertexCorner(const int iV, const int j) const;
+     int     getVertexFace(const int iV, const int j)  const;
+
+  // edges incident to vertex iV, in increasing order of edge index,
+  // and the opposite ends of those edges;
+  // 0<=j<getNumberOfVertexEdges(iV)
+
+     int     getNumberOfVertexEdges(const int iV)      const;
+     int     getVertexEdge(const int iV, const int j)  const;
+     int     getVertexNeighbor(const int iV, const int j) const;
+
+  // rotation around the vertex iV=getSrc(iC): these methods return the
+  // corner incident to iV in the face adjacent to the face of iC
+  // across the edge (iV,getSrc(getPrev(iC))), or across the edge
+  // (iV,getDst(iC)), respectively; they take into account the
+  // relative orientation of the two faces, and return -1 across
+  // boundary and singular edges; note that the direction of rotation
+  // defined by these methods is reversed across inconsistently
+  // oriented faces
+
+     int     getNextCornerAroundVertex(const int iC)   const;
+     int     getPrevCornerAroundVertex(const int iC)   const;
+
+  // if iV is a regular vertex, fills the corners array with the
+  // corners incident to iV in rotational order, where consecutive
+  // corners belong to faces sharing an edge, even across inconsistently
+  // oriented faces, starting at a boundary
+  // corner if iV is a boundary vertex, and returns the number of
+  // corners; returns -1 if iV is singular or out of range, or if the
+  // vertex stars have not been built
+
+     int     getVertexCornerRotation(const int iV, vector<int>& corners) const;
   
+protected:
+
+  using HalfEdgesType::_coordIndex;
+  using HalfEdgesType::_firstCornerEdge;
+  using HalfEdgesType::_cornerEdge;
+
 private:
 
   // consider these private variables a suggestion
@@ -172,7 +259,19 @@ private:
 
   vector<int>      _nPartsVertex;
   vector<bool> _isBoundaryVertex;
+  int              _nComponents;
+  vector<int>      _faceComponent;
+
+  // vertex stars, as arrays of arrays
+  vector<int>      _firstCornerVertex;
+  vector<int>      _cornerVertex;
+  vector<int>      _firstEdgeVertex;
+  vector<int>      _edgeVertex;
   
 };
 
+typedef PolygonMeshT<HalfEdges>         PolygonMesh;
+typedef PolygonMeshT<TriangleHalfEdges> TrianglePolygonMesh;
+typedef PolygonMeshT<QuadHalfEdges>     QuadPolygonMesh;
+
 #endif /* _POLYGONMESH_HPP_ */
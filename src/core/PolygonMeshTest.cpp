@@ -40,15 +40,117 @@
 // DAMAGE.
 
 #include <iostream>
+#include <chrono>
 #include "PolygonMeshTest.hpp"
+#include <util/Parallel.hpp>
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
 #include <wrl/Material.hpp>
 #include <wrl/IndexedFaceSet.hpp>
 #include <wrl/SceneGraphTraversal.hpp>
 
+template<class Mesh0, class Mesh1>
+bool PolygonMeshTest::_isIdentical(Mesh0& pm0, Mesh1& pm1) {
+  int nV = pm0.getNumberOfVertices();
+  int nE = pm0.getNumberOfEdges();
+  int nC = pm0.getNumberOfCorners();
+  if(pm1.getNumberOfVertices()!=nV ||
+     pm1.getNumberOfEdges()!=nE ||
+     pm1.getNumberOfCorners()!=nC ||
+     pm1.getNumberOfFaces()!=pm0.getNumberOfFaces() ||
+     pm1.getNumberOfConnectedComponents()!=pm0.getNumberOfConnectedComponents())
+    return false;
+  int iV,iE,iC,iF,j;
+  for(iF=0;iF<pm0.getNumberOfFaces();iF++)
+    if(pm0.getFaceConnectedComponent(iF)!=pm1.getFaceConnectedComponent(iF))
+      return false;
+  for(iV=0;iV<nV;iV++)
+    if(pm0.isBoundaryVertex(iV)!=pm1.isBoundaryVertex(iV) ||
+       pm0.isSingularVertex(iV)!=pm1.isSingularVertex(iV))
+      return false;
+  for(iE=0;iE<nE;iE++) {
+    if(pm0.getVertex0(iE)!=pm1.getVertex0(iE) ||
+       pm0.getVertex1(iE)!=pm1.getVertex1(iE) ||
+       pm0.getNumberOfEdgeHalfEdges(iE)!=pm1.getNumberOfEdgeHalfEdges(iE))
+      return false;
+    for(j=0;j<pm0.getNumberOfEdgeHalfEdges(iE);j++)
+      if(pm0.getEdgeHalfEdge(iE,j)!=pm1.getEdgeHalfEdge(iE,j))
+        return false;
+  }
+  for(iC=0;iC<nC;iC++)
+    if(pm0.getFace(iC)!=pm1.getFace(iC) ||
+       pm0.getTwin(iC)!=pm1.getTwin(iC) ||
+       pm0.getNext(iC)!=pm1.getNext(iC) ||
+       pm0.getPrev(iC)!=pm1.getPrev(iC) ||
+       pm0.getDst(iC)!=pm1.getDst(iC) ||
+       pm0.getHalfEdgeEdge(iC)!=pm1.getHalfEdgeEdge(iC))
+      return false;
+  return true;
+}
+
+template<class Mesh>
+void PolygonMeshTest::_printMesh(Mesh& pMesh, const string& indent) {
+  int nV = pMesh.getNumberOfVertices();
+  int nE = pMesh.getNumberOfEdges();
+  int nF = pMesh.getNumberOfFaces();
+  int nC = pMesh.getNumberOfCorners();
+
+  _ostr << indent << "        nV          = " << nV << endl;
+  _ostr << indent << "        nE          = " << nE << endl;
+  _ostr << indent << "        nF          = " << nF << endl;
+  _ostr << indent << "        nC          = " << nC << endl;
+
+  // print info about the polygon mesh
+
+  int nV_boundary  = 0;
+  int nV_internal  = 0;
+  int nV_singular  = 0;
+  int nV_regular   = 0;
+  int nE_boundary  = 0;
+  int nE_regular   = 0;
+  int nE_singular  = 0;
+  int nE_other     = 0;
+
+  int iE,iV;
+
+  for(iE=0;iE<nE;iE++) {
+    if(pMesh.isBoundaryEdge(iE)) {
+      nE_boundary++;
+    } else if(pMesh.isRegularEdge(iE)) {
+      nE_regular++;
+    } else if(pMesh.isSingularEdge(iE)) {
+      nE_singular++;
+    } else {
+      nE_other++;
+    }
+  }
+
+  for(iV=0;iV<nV;iV++) {
+    if(pMesh.isBoundaryVertex(iV))
+      nV_boundary++;
+    if(pMesh.isSingularVertex(iV))
+      nV_singular++;
+  }
+
+  nV_internal = nV-nV_boundary;
+  nV_regular  = nV-nV_singular;
+
+  _ostr << indent << "        nV_boundary = " << nV_boundary << endl;
+  _ostr << indent << "        nV_internal = " << nV_internal << endl;
+  _ostr << indent << "        nV_regular  = " << nV_regular  << endl;
+  _ostr << indent << "        nV_singular = " << nV_singular << endl;
+  _ostr << indent << "        nE_boundary = " << nE_boundary << endl;
+  _ostr << indent << "        nE_regular  = " << nE_regular  << endl;
+  _ostr << indent << "        nE_singular = " << nE_singular << endl;
+  _ostr << indent << "        nE_other    = " << nE_other    << endl;
+  _ostr << indent << "        isRegular   = " << pMesh.isRegular() << endl;
+  _ostr << indent << "        hasBoundary = " << pMesh.hasBoundary() << endl;
+}
+
 PolygonMeshTest::PolygonMeshTest
-(SceneGraph& wrl, const string& indent, ostream& ostr):_ostr(ostr) {
+(SceneGraph& wrl, const string& indent, ostream& ostr, const int nThreads,
+ const bool testTriangleMesh):
+  _ostr(ostr) {
   _ostr << indent << "PolygonMeshTest {" << endl;
 
   int nIndexedFaceSet = 0;
@@ -95,65 +197,43 @@ PolygonMeshTest::PolygonMeshTest
 
         _ostr << indent << "      PolygonMesh(nV,coordIndex) {" << endl;
 
+        auto t0 = chrono::steady_clock::now();
         PolygonMesh pMesh(nVifs,coordIndex);
-
-        int nV = pMesh.getNumberOfVertices();
-        int nE = pMesh.getNumberOfEdges();
-        int nF = pMesh.getNumberOfFaces();
-        int nC = pMesh.getNumberOfCorners();
-
-        _ostr << indent << "        nV          = " << nV << endl;
-        _ostr << indent << "        nE          = " << nE << endl;
-        _ostr << indent << "        nF          = " << nF << endl;
-        _ostr << indent << "        nC          = " << nC << endl;
-
-        // print info about the polygon mesh
-
-        int nV_boundary  = 0;
-        int nV_internal  = 0;
-        int nV_singular  = 0;
-        int nV_regular   = 0;
-        int nE_boundary  = 0;
-        int nE_regular   = 0;
-        int nE_singular  = 0;
-        int nE_other     = 0;
-
-        int iE,iV;
-
-        for(iE=0;iE<nE;iE++) {
-          if(pMesh.isBoundaryEdge(iE)) {
-            nE_boundary++;
-          } else if(pMesh.isRegularEdge(iE)) {
-            nE_regular++;
-          } else if(pMesh.isSingularEdge(iE)) {
-            nE_singular++;
-          } else {
-            nE_other++;
-          }
-        }
-
-        for(iV=0;iV<nV;iV++) {
-          if(pMesh.isBoundaryVertex(iV))
-            nV_boundary++;
-          if(pMesh.isSingularVertex(iV))
-            nV_singular++;
+        auto t1 = chrono::steady_clock::now();
+
+        _printMesh(pMesh,indent);
+
+        if(nThreads!=1) {
+          auto t2 = chrono::steady_clock::now();
+          PolygonMesh pMeshParallel(nVifs,coordIndex,nThreads);
+          auto t3 = chrono::steady_clock::now();
+          // the parallel mesh is queried through the navigation tables,
+          // and the serial one by searching the coordIndex array
+          pMeshParallel.buildNavigation(nThreads);
+          double tSerial   = chrono::duration<double,milli>(t1-t0).count();
+          double tParallel = chrono::duration<double,milli>(t3-t2).count();
+          int nT = (nThreads>0)?nThreads:Parallel::getNumberOfCores();
+          _ostr << indent << "        speedup {" << endl;
+          _ostr << indent << "          nThreads  = " << nT << endl;
+          _ostr << indent << "          tSerial   = " << tSerial << " ms" << endl;
+          _ostr << indent << "          tParallel = " << tParallel << " ms" << endl;
+          _ostr << indent << "          speedup   = "
+                << ((tParallel>0.0)?tSerial/tParallel:0.0) << endl;
+          _ostr << indent << "          identical = "
+                << _isIdentical(pMesh,pMeshParallel) << endl;
+          _ostr << indent << "        } speedup" << endl;
         }
 
-        nV_internal = nV-nV_boundary;
-        nV_regular  = nV-nV_singular;
-
-        _ostr << indent << "        nV_boundary = " << nV_boundary << endl;
-        _ostr << indent << "        nV_internal = " << nV_internal << endl;
-        _ostr << indent << "        nV_regular  = " << nV_regular  << endl;
-        _ostr << indent << "        nV_singular = " << nV_singular << endl;
-        _ostr << indent << "        nE_boundary = " << nE_boundary << endl;
-        _ostr << indent << "        nE_regular  = " << nE_regular  << endl;
-        _ostr << indent << "        nE_singular = " << nE_singular << endl;
-        _ostr << indent << "        nE_other    = " << nE_other    << endl;
-        _ostr << indent << "        isRegular   = " << pMesh.isRegular() << endl;
-        _ostr << indent << "        hasBoundary = " << pMesh.hasBoundary() << endl;
-
         _ostr << indent << "      } PolygonMesh" << endl;
+
+        if(testTriangleMesh && ifs->isTriangleMesh()) {
+          _ostr << indent << "      TrianglePolygonMesh(nV,coordIndex) {" << endl;
+          TrianglePolygonMesh tMesh(nVifs,coordIndex);
+          _printMesh(tMesh,indent);
+          _ostr << indent << "        identical   = "
+                << _isIdentical(pMesh,tMesh) << endl;
+          _ostr << indent << "      } TrianglePolygonMesh" << endl;
+        }
         _ostr << indent << "    } IndexedFaceSet" << endl;
         nIndexedFaceSet++;
       } else {
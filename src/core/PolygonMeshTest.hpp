@@ -50,10 +50,28 @@ class PolygonMeshTest {
   
 public:
 
-  PolygonMeshTest(SceneGraph& wrl, const string& indent="", ostream& ostr=cout);
+  // if nThreads!=1 the PolygonMesh of each IndexedFaceSet is also
+  // constructed with nThreads threads, and a speedup report comparing
+  // the serial and parallel constructions is printed; if
+  // testTriangleMesh is true, a TrianglePolygonMesh is also
+  // constructed for each triangle mesh, and compared with the
+  // PolygonMesh
+
+  PolygonMeshTest(SceneGraph& wrl, const string& indent="", ostream& ostr=cout,
+                  const int nThreads=1, const bool testTriangleMesh=false);
 
 private:
 
+  // prints the vertex and edge classification of the mesh; works for
+  // PolygonMesh, TrianglePolygonMesh and QuadPolygonMesh
+  template<class Mesh>
+  void _printMesh(Mesh& pMesh, const string& indent);
+
+  // returns true if the two meshes have identical data structures, as
+  // observed through the public query methods
+  template<class Mesh0, class Mesh1>
+  static bool _isIdentical(Mesh0& pm0, Mesh1& pm1);
+
   ostream& _ostr;
 
 };
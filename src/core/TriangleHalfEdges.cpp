@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleHalfEdges.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "TriangleHalfEdges.hpp"
+#include <io/StrException.hpp>
+#include <util/Parallel.hpp>
+
+template<int N>
+NgonHalfEdges<N>::NgonHalfEdges
+(const int nV, const vector<int>& coordIndex, const int nThreads):
+  Edges(nV),
+  _coordIndex(coordIndex),
+  _nFaces(0),
+  _twin(),
+  _firstCornerEdge(),
+  _cornerEdge(),
+  _halfEdgeEdge()
+{
+  int nC = static_cast<int>(_coordIndex.size());
+
+  // 0) verify that every face has exactly N corners, and that all the
+  //    vertex indices are in range
+  if(nC%(N+1)!=0)
+    throw new StrException("coordIndex is not an N-gon mesh");
+  int nR = Parallel::getNumberOfRanges(nThreads,nC);
+  vector<char> badRange(nR,0);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      for(int iC=i0;iC<i1;iC++) {
+        int iV = _coordIndex[iC];
+        if((iC%(N+1)==N)?(iV!=-1):(iV<0 || iV>=nV))
+          badRange[k] = 1;
+      }
+    });
+  for(int k=0;k<nR;k++)
+    if(badRange[k])
+      throw new StrException("coordIndex is not an N-gon mesh");
+  _nFaces = nC/(N+1);
+  int nH = N*_nFaces;
+
+  // 1) insert all the edges in bulk
+  vector<int> cornerEdge;
+  _insertEdges(_coordIndex,cornerEdge,_firstCornerEdge,_cornerEdge,nThreads);
+
+  // 2) remove the face separators from the corner to edge map
+  _halfEdgeEdge.resize(nH);
+  Parallel::forRanges(nThreads,nH,[&](int /*k*/, int h0, int h1) {
+      for(int h=h0;h<h1;h++)
+        _halfEdgeEdge[h] = cornerEdge[_corner(h)];
+    });
+
+  // 3) fill the _twin array; only the two half edges incident to a
+  //    regular edge are made twins
+  _twin.assign(nH,-1);
+  int nE = getNumberOfEdges();
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0,j;iE<e1;iE++) {
+        if(_firstCornerEdge[iE+1]-(j=_firstCornerEdge[iE])!=2) continue;
+        _twin[_halfEdge(_cornerEdge[j  ])] = _cornerEdge[j+1];
+        _twin[_halfEdge(_cornerEdge[j+1])] = _cornerEdge[j  ];
+      }
+    });
+}
+
+template<int N>
+int NgonHalfEdges<N>::getNumberOfCorners() {
+  return static_cast<int>(_coordIndex.size());
+}
+
+template<int N>
+int NgonHalfEdges<N>::getNumberOfFaces() const {
+  return _nFaces;
+}
+
+template<int N>
+bool NgonHalfEdges<N>::isValidCoord(const int iC) const {
+  return (iC>=0 && iC<static_cast<int>(_coordIndex.size()) && iC%(N+1)!=N);
+}
+
+template<int N>
+bool NgonHalfEdges<N>::isValidEdge(const int iE) const {
+  return (iE>=0 && iE<getNumberOfEdges());
+}
+
+template<int N>
+int NgonHalfEdges<N>::getFace(const int iC) const {
+  return isValidCoord(iC)?iC/(N+1):-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getSrc(const int iC) const {
+  return isValidCoord(iC)?_coordIndex[iC]:-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getDst(const int iC) const {
+  return isValidCoord(iC)?_coordIndex[getNext(iC)]:-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getNext(const int iC) const {
+  if(!isValidCoord(iC)) return -1;
+  int iC0 = (N+1)*(iC/(N+1));
+  return iC0+(iC-iC0+1)%N;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getPrev(const int iC) const {
+  if(!isValidCoord(iC)) return -1;
+  int iC0 = (N+1)*(iC/(N+1));
+  return iC0+(iC-iC0+N-1)%N;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getTwin(const int iC) const {
+  return isValidCoord(iC)?_twin[_halfEdge(iC)]:-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getHalfEdgeEdge(const int iC) const {
+  return isValidCoord(iC)?_halfEdgeEdge[_halfEdge(iC)]:-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getNumberOfEdgeHalfEdges(const int iE) const {
+  return isValidEdge(iE)?_firstCornerEdge[iE+1]-_firstCornerEdge[iE]:-1;
+}
+
+template<int N>
+int NgonHalfEdges<N>::getEdgeHalfEdge(const int iE, const int j) const {
+  if(!isValidEdge(iE) || j<0 || j>=getNumberOfEdgeHalfEdges(iE)) return -1;
+  return _cornerEdge[_firstCornerEdge[iE]+j];
+}
+
+template<int N>
+void NgonHalfEdges<N>::buildNavigation(const int /*nThreads*/) {
+}
+
+template<int N>
+bool NgonHalfEdges<N>::hasNavigation() const {
+  return true;
+}
+
+template class NgonHalfEdges<3>;
+template class NgonHalfEdges<4>;
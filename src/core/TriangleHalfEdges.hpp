@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleHalfEdges.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _TRIANGLE_HALF_EDGES_HPP_
+#define _TRIANGLE_HALF_EDGES_HPP_
+
+#include <vector>
+#include "Edges.hpp"
+
+using namespace std;
+
+// NgonHalfEdges<N> has the same query interface as HalfEdges, but it
+// only accepts meshes where every face has exactly N corners, such as
+// the IndexedFaceSets for which isTriangleMesh() is true
+//
+// - corner indices are the indices of the coordIndex array, as in
+//   HalfEdges, so that the face of corner iC is iC/(N+1), and the
+//   next and previous corners are computed arithmetically
+// - no face separators are stored in the internal arrays, which are
+//   indexed by half edge number h = iC-iC/(N+1), 0<=h<N*nF
+// - there is no _face array, and face sizes are not stored
+//
+// explicit instantiations are provided for N=3 and N=4
+
+template<int N>
+class NgonHalfEdges : public Edges {
+
+public:
+
+  // the constructor throws an StrException if coordIndex does not
+  // describe a mesh of N-gons, or if it contains vertex indices out of
+  // range; the work is split among nThreads threads, or all the
+  // available cores if nThreads<=0
+
+          NgonHalfEdges(const int nV, const vector<int>& coordIndex,
+                        const int nThreads=1);
+
+  int     getNumberOfCorners();
+  int     getNumberOfFaces() const;
+
+  int     getFace(const int iC) const;
+  int     getSrc(const int iC) const;
+  int     getDst(const int iC) const;
+  int     getNext(const int iC) const;
+  int     getPrev(const int iC) const;
+  int     getTwin(const int iC) const;
+  int     getHalfEdgeEdge(const int iC) const;
+  int     getNumberOfEdgeHalfEdges(const int iE) const;
+  int     getEdgeHalfEdge(const int iE, const int j) const;
+
+  // navigation is always constant time; buildNavigation() does nothing
+
+  void    buildNavigation(const int nThreads=1);
+  bool    hasNavigation() const;
+
+  bool    isValidCoord(const int iC) const;
+  bool    isValidEdge(const int iE) const;
+
+protected:
+
+  static int _halfEdge(const int iC) { return iC-iC/(N+1); }
+  static int _corner(const int h)    { return h+h/N;       }
+
+  // reference to the coordIndex passed as argument
+  const vector<int>& _coordIndex;
+
+        int          _nFaces;
+
+  // array of twin corners, indexed by half edge number
+        vector<int>  _twin;
+
+  // the edge to half-edge incidence relations, as in HalfEdges
+        vector<int>  _firstCornerEdge;
+        vector<int>  _cornerEdge;
+
+  // mapping from half edges to edges, indexed by half edge number
+        vector<int>  _halfEdgeEdge;
+
+};
+
+typedef NgonHalfEdges<3> TriangleHalfEdges;
+typedef NgonHalfEdges<4> QuadHalfEdges;
+
+#endif /* _TRIANGLE_HALF_EDGES_HPP_ */
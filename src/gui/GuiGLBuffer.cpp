@@ -68,17 +68,20 @@ GuiGLBuffer::GuiGLBuffer(IndexedFaceSet* pIfs, QColor& materialColor):
 
   if(pIfs==(IndexedFaceSet*)0) return;
 
-  vector<float>& coord       = pIfs->getCoord();
-  vector<int>&   coordIndex  = pIfs->getCoordIndex();
+  // read only access, which does not copy arrays shared with snapshots
+  const IndexedFaceSet& ifs = *pIfs;
+
+  const vector<float>& coord       = ifs.getCoord();
+  const vector<int>&   coordIndex  = ifs.getCoordIndex();
 
   bool           colorPerVertex = pIfs->getColorPerVertex();
-  vector<float>& color       = pIfs->getColor();
-  vector<int>&   colorIndex  = pIfs->getColorIndex();
+  const vector<float>& color       = ifs.getColor();
+  const vector<int>&   colorIndex  = ifs.getColorIndex();
   // IndexedFaceSet::Binding   cBinding    = pIfs->getColorBinding();
 
   bool           normalPerVertex = pIfs->getNormalPerVertex();
-  vector<float>& normal      = pIfs->getNormal();
-  vector<int>&   normalIndex = pIfs->getNormalIndex();
+  const vector<float>& normal      = ifs.getNormal();
+  const vector<int>&   normalIndex = ifs.getNormalIndex();
   // IndexedFaceSet::Binding   nBinding    = pIfs->getNormalBinding();
 
   // int         nV          = pIfs->getNumberOfCoord();
@@ -267,10 +270,12 @@ GuiGLBuffer::GuiGLBuffer(IndexedLineSet* pIls, QColor& materialColor):
 
   if(pIls==(IndexedLineSet*)0) return;
 
-  vector<float>& coord          = pIls->getCoord();
-  vector<int>&   coordIndex     = pIls->getCoordIndex();
-  vector<float>& color          = pIls->getColor();
-  vector<int>&   colorIndex     = pIls->getColorIndex();
+  const IndexedLineSet& ils = *pIls;
+
+  const vector<float>& coord          = ils.getCoord();
+  const vector<int>&   coordIndex     = ils.getCoordIndex();
+  const vector<float>& color          = ils.getColor();
+  const vector<int>&   colorIndex     = ils.getColorIndex();
   bool           colorPerVertex = pIls->getColorPerVertex();
   // int         nV             = pIls->getNumberOfCoord();
   int            nP             = pIls->getNumberOfPolylines();
@@ -35,6 +35,7 @@
 #include <iostream>
 #include <string.h>
 #include <math.h>
+#include <set>
 
 #include <QPainter>
 #include <QPaintEngine>
@@ -46,7 +47,7 @@
 #include "GuiQtLogo.hpp"
 #include "GuiGLBuffer.hpp"
 
-#include "wrl/SceneGraphTraversal.hpp"
+#include "wrl/SceneGraphFlat.hpp"
 
 #ifdef near
 # undef near
@@ -96,6 +97,7 @@ GuiGLWidget::GuiGLWidget(QWidget* parent):
   _cameraTranslation(0,0,0),
   _animationOn(true),
   _fAngle(0),
+  _mvpTransformVersion(0),
   _background(qRgb(200,200,200)),
   _material(qRgb(225,150,75)),
   _lightSource(0.0, 0.3, -1.0) {
@@ -112,13 +114,13 @@ GuiGLWidget::GuiGLWidget(QWidget* parent):
 //////////////////////////////////////////////////////////////////////
 GuiGLWidget::~GuiGLWidget() {
   makeCurrent();
-  map<Shape*,GuiGLShader*>::iterator i;
-  for(i=_shaderMap.begin();i!=_shaderMap.end();i++) {
-    // Shape* shape = i->first;
+  map<pair<Node*,Node*>,GuiGLShader*>::iterator i;
+  for(i=_shaders.begin();i!=_shaders.end();i++) {
     GuiGLShader* shader = i->second;
     i->second = (GuiGLShader*)0;
     delete shader;
   }
+  _shaders.clear();
   _shaderMap.clear();
   delete _handles;
   doneCurrent();
@@ -142,14 +144,13 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
 
   // cout << "  _shaderMap.size() = "<< _shaderMap.size() <<"\n";
   // cout << "  deleting old shaders ... \n";
-  map<Shape*,GuiGLShader*>::iterator i;
-  for(i=_shaderMap.begin();i!=_shaderMap.end();i++) {
-    Shape* shape = i->first;
-    cout << "    found Shape \"" << shape->getName() << "\"\n";
+  map<pair<Node*,Node*>,GuiGLShader*>::iterator i;
+  for(i=_shaders.begin();i!=_shaders.end();i++) {
     GuiGLShader* shader = i->second;
     i->second = (GuiGLShader*)0;
     delete shader;
   }
+  _shaders.clear();
   _shaderMap.clear();
 
   // cout << "  _shaderMap.size() = "<< _shaderMap.size() <<"\n";
@@ -159,13 +160,23 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
 
     // cout << "  creating new shaders ... \n";
 
-    SceneGraphTraversal sgt(*pWrl);
-    sgt.start();
+    SceneGraphFlat& flat = pWrl->getFlat();
+    int nNodes = flat.getNumberOfNodes();
     Node* node=(Node*)0;
-    while((node=sgt.next())!=(Node*)0) {
-      if(Shape* shape = dynamic_cast<Shape*>(node)) {
+    for(int iNode=0;iNode<nNodes;iNode++) {
+      if(flat.getKind(iNode)==SceneGraphFlat::SHAPE) {
+        Shape* shape = (Shape*)flat.getNode(iNode);
 
         // cout << "    found Shape \"" << shape->getName() << "\"\n";
+
+        // Shapes instanced with USE, which share the appearance and
+        // the geometry, also share the shader and the vertex buffer
+        pair<Node*,Node*> key(shape->getGeometry(),shape->getAppearance());
+        map<pair<Node*,Node*>,GuiGLShader*>::iterator i = _shaders.find(key);
+        if(i!=_shaders.end()) {
+          _shaderMap[shape] = i->second;
+          continue;
+        }
         
         QColor materialColor(255,150,90);
 
@@ -213,6 +224,7 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
           GuiGLBuffer* ifsb   = new GuiGLBuffer(pIfs, materialColor);
           GuiGLShader* shader = new GuiGLShader(materialColor,&_lightSource);
           shader->setVertexBuffer(ifsb);
+          _shaders[key] = shader;
           _shaderMap[shape] = shader;
 
         } else if(IndexedLineSet* pIls = dynamic_cast<IndexedLineSet*>(node)) {
@@ -227,6 +239,7 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
           GuiGLBuffer* ifsb   = new GuiGLBuffer(pIls, materialColor);
           GuiGLShader* shader = new GuiGLShader(materialColor);
           shader->setVertexBuffer(ifsb);
+          _shaders[key] = shader;
           _shaderMap[shape] = shader;
 
         }
@@ -279,25 +292,29 @@ void GuiGLWidget::setQtLogo() {
 //////////////////////////////////////////////////////////////////////
 void GuiGLWidget::invertNormal() {
 
-  map<Shape*,GuiGLShader*>::iterator i;
-  for(i=_shaderMap.begin();i!=_shaderMap.end();i++) {
-    Shape*         shape    = i->first;
+  // the normals of a geometry shared by several shaders are inverted
+  // only once
+  set<Node*> inverted;
+  map<pair<Node*,Node*>,GuiGLShader*>::iterator i;
+  for(i=_shaders.begin();i!=_shaders.end();i++) {
     GuiGLShader*   shader   = i->second;
     GuiGLBuffer*   vbo      = shader->getVertexBuffer();
 
-    Node* geometry = shape->getGeometry();
+    Node* geometry = i->first.first;
     if(IndexedFaceSet* ifs=dynamic_cast<IndexedFaceSet*>(geometry)) {
 
-      vector<float> &normal = ifs->getNormal();    
-      float n0,n1,n2;
-      for(unsigned i=0;i<normal.size();i+=3) {
-        n0 = normal[i+0]; n1 = normal[i+1]; n2 = normal[i+2];
-        normal[i+0] = -n0; normal[i+1] = -n1; normal[i+2] = -n2;
+      if(inverted.insert(geometry).second) {
+        vector<float> &normal = ifs->getNormal();    
+        float n0,n1,n2;
+        for(unsigned i=0;i<normal.size();i+=3) {
+          n0 = normal[i+0]; n1 = normal[i+1]; n2 = normal[i+2];
+          normal[i+0] = -n0; normal[i+1] = -n1; normal[i+2] = -n2;
+        }
       }
 
       QColor materialColor(255,150,90);
       if(Appearance* appearance =
-         dynamic_cast<Appearance*>(shape->getAppearance())) {
+         dynamic_cast<Appearance*>(i->first.second)) {
         if(Material* material =
            dynamic_cast<Material*>(appearance->getMaterial())) {
           Color& diffuseColor = material->getDiffuseColor();
@@ -368,49 +385,60 @@ void GuiGLWidget::paintShape(QMatrix4x4& mvp, Shape* shape) {
 }
 
 //////////////////////////////////////////////////////////////////////
-void GuiGLWidget::paintGroup(QMatrix4x4& mvp, Group* group) {
-  if(group==(Group*)0 || group->getShow()==false) return;
-  unsigned nChildren = group->getNumberOfChildren();
-  for(unsigned i=0;i<nChildren;i++) {
-    Node* node = (*group)[i];
-    if(Shape* s = dynamic_cast<Shape*>(node)) {
-      paintShape(mvp, s);
-    } else if(Transform* t = dynamic_cast<Transform*>(node)) {
-      paintTransform(mvp, t);
-    } else if(Group* g = dynamic_cast<Group*>(node)) {
-      paintGroup(mvp, g);
-    }
-  }
-}
+// the nodes are visited in the order of the flattened scene graph; the
+// matrix of each Transform node is composed with the one of its
+// enclosing Transform, or with mvp, and stored by node index for the
+// nodes it encloses; hidden groups are skipped together with their
+// subtrees
+void GuiGLWidget::paintSceneGraph(QMatrix4x4& mvp, SceneGraph* wrl) {
+  if(wrl==(SceneGraph*)0 || wrl->getShow()==false) return;
 
-//////////////////////////////////////////////////////////////////////
-void GuiGLWidget::paintTransform(QMatrix4x4& mvp, Transform* transform) {
-  if(transform==(Transform*)0 || transform->getShow()==false) return;
-
-  float T[16] = {
-    1.0f, 0.0f, 0.0f, 0.0f,
-    0.0f, 1.0f, 0.0f, 0.0f,
-    0.0f, 0.0f, 1.0f, 0.0f,
-    0.0f, 0.0f, 0.0f, 1.0f
+  class PaintVisitor : public SceneGraphVisitor {
+  public:
+    GuiGLWidget&       widget;
+    SceneGraphFlat&    flat;
+    QMatrix4x4&        mvp;
+    vector<QMatrix4x4>& mvpt;
+    PaintVisitor(GuiGLWidget& w, SceneGraphFlat& f, QMatrix4x4& m,
+                 vector<QMatrix4x4>& t):
+      widget(w),flat(f),mvp(m),mvpt(t) { }
+    QMatrix4x4& matrix(const int iNode) {
+      int iTransform = flat.getTransform(iNode);
+      return (iTransform<0)?mvp:mvpt[iTransform];
+    }
+    using SceneGraphVisitor::visit;
+    bool visit(Group& group, int /*iNode*/) {
+      return group.getShow();
+    }
+    bool visit(Transform& transform, int iNode) {
+      if(transform.getShow()==false) return false;
+      float T[16];
+      transform.getMatrix(T);
+      // the enclosing Transform precedes this one in the pre-order,
+      // so its entry is already composed with mvp
+      mvpt[iNode] =
+        matrix(iNode) *
+        QMatrix4x4(T[ 0],T[ 1],T[ 2],T[ 3],
+                   T[ 4],T[ 5],T[ 6],T[ 7],
+                   T[ 8],T[ 9],T[10],T[11],
+                   T[12],T[13],T[14],T[15]);
+      return true;
+    }
+    void visit(Shape& shape, int iNode) {
+      widget.paintShape(matrix(iNode),&shape);
+    }
   };
 
-  transform->getMatrix(T);
-
-  // mvpt = mvp * T
-  QMatrix4x4 mvpt =
-    mvp *
-    QMatrix4x4(T[ 0],T[ 1],T[ 2],T[ 3],
-               T[ 4],T[ 5],T[ 6],T[ 7],
-               T[ 8],T[ 9],T[10],T[11],
-               T[12],T[13],T[14],T[15]);
-
-  paintGroup(mvpt, transform);
-}
-
-//////////////////////////////////////////////////////////////////////
-void GuiGLWidget::paintSceneGraph(QMatrix4x4& mvp, SceneGraph* wrl) {
-  if(wrl==(SceneGraph*)0 || wrl->getShow()==false) return;
-  paintGroup(mvp,wrl);
+  SceneGraphFlat& flat = wrl->getFlat();
+  size_t nNodes = static_cast<size_t>(flat.getNumberOfNodes());
+  // the size is also checked, since a different scene graph may be at
+  // the same version
+  if(_mvpTransformVersion!=flat.getVersion() || _mvpTransform.size()!=nNodes) {
+    _mvpTransform.resize(nNodes);
+    _mvpTransformVersion = flat.getVersion();
+  }
+  PaintVisitor visitor(*this,flat,mvp,_mvpTransform);
+  flat.traverse(visitor);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -100,8 +100,6 @@ protected:
   // virtual void resizeEvent(QResizeEvent * event) Q_DECL_OVERRIDE;
 
   void paintData(QMatrix4x4& mvp);
-  void paintGroup(QMatrix4x4& mvp, Group* group);
-  void paintTransform(QMatrix4x4& mvp, Transform* transform);
   void paintSceneGraph(QMatrix4x4& mvp, SceneGraph* wrl);
   void paintShape(QMatrix4x4& mvp, Shape* shape);
 
@@ -145,8 +143,17 @@ private:
   bool                  _animationOn;
   qreal                 _fAngle;
 
+  // shaders owned by the widget, by geometry and appearance; the
+  // Shapes which share both are drawn with the same shader
+  map<pair<Node*,Node*>,GuiGLShader*> _shaders;
   map<Shape*,GuiGLShader*> _shaderMap;
 
+  // mvp composed with the world matrix of each Transform, by node index
+  // of the flattened scene graph; resized only when the flattened graph
+  // is rebuilt
+  vector<QMatrix4x4>    _mvpTransform;
+  unsigned              _mvpTransformVersion;
+
   GuiGLHandles*         _handles;
 
   QColor                _background;
@@ -215,6 +215,28 @@ void GuiMainWindow::on_fileSaveAction_triggered() {
   }
 }
 
+//////////////////////////////////////////////////////////////////////
+void GuiMainWindow::on_editUndoAction_triggered() {
+  if(getData().undo()) {
+    glWidget->setSceneGraph(getSceneGraph(),false);
+    toolsWidget->updateState();
+    refresh();
+  } else {
+    showStatusBarMessage("nothing to undo");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void GuiMainWindow::on_editRedoAction_triggered() {
+  if(getData().redo()) {
+    glWidget->setSceneGraph(getSceneGraph(),false);
+    toolsWidget->updateState();
+    refresh();
+  } else {
+    showStatusBarMessage("nothing to redo");
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 void GuiMainWindow::on_fileExitAction_triggered() {
   close();
@@ -81,6 +81,8 @@ private slots:
   void on_fileExitAction_triggered();
   void on_fileLoadAction_triggered();
   void on_fileSaveAction_triggered();
+  void on_editUndoAction_triggered();
+  void on_editRedoAction_triggered();
   void on_toolsShowAction_triggered();
   void on_toolsHideAction_triggered();
   void on_helpAboutAction_triggered();
@@ -104,6 +104,7 @@ GuiQtLogo::GuiQtLogo():
   vector<float>& coord = _pIfs->getCoord();
   for (unsigned i = 0;i < coord.size();i++)
     coord[i] *= 2.0f;
+  _pIfs->setBBoxDirty();
 
   updateBBox();
 }
@@ -92,6 +92,7 @@ void GuiToolsWidget::updateState() {
 
   spinBoxBBoxDepth->setValue(bboxDepth);
   checkBoxBBoxCube->setChecked(bboxCube);
+  checkBoxBBoxOccupied->setChecked(data.getBBoxOccupied());
   editBBoxScale->setText("  "+QString::number(bboxScale,'f',2));
 
   int N = 1<<bboxDepth;
@@ -133,39 +134,42 @@ void GuiToolsWidget::updateState() {
 
   } else /* if(wrl!=(SceneGraph*)0) */ {
 
+    // all the properties are computed in a single traversal
     SceneGraphProcessor processor(*wrl);
+    SceneSummary summary;
+    processor.getSceneSummary(summary);
 
-    bool hasBBox   = processor.hasBBox();
+    bool hasBBox   = summary.hasBBox;
     pushButtonBBoxAdd->setEnabled(!hasBBox);
     pushButtonBBoxRemove->setEnabled(hasBBox);
 
     bool hasNormal = false;
-    bool hasFaces  = processor.hasIndexedFaceSetFaces();
-    bool value     = processor.hasIndexedFaceSetNormalNone();
+    bool hasFaces  = summary.hasIndexedFaceSetFaces;
+    bool value     = summary.hasIndexedFaceSetNormalNone;
     pushButtonSceneGraphNormalNone->setEnabled(!value);
-    value = processor.hasIndexedFaceSetNormalPerVertex();
+    value = summary.hasIndexedFaceSetNormalPerVertex;
     hasNormal |= value;
     pushButtonSceneGraphNormalPerVertex->setEnabled(hasFaces && !value);
-    value = processor.hasIndexedFaceSetNormalPerFace();
+    value = summary.hasIndexedFaceSetNormalPerFace;
     hasNormal |= value;
     pushButtonSceneGraphNormalPerFace->setEnabled(hasFaces && !value);
-    value = processor.hasIndexedFaceSetNormalPerCorner();
+    value = summary.hasIndexedFaceSetNormalPerCorner;
     hasNormal |= value;
     pushButtonSceneGraphNormalPerCorner->setEnabled(hasFaces && !value);
     pushButtonSceneGraphNormalInvert->setEnabled(hasNormal);
 
-    value = processor.hasIndexedFaceSetShown();
+    value = summary.hasIndexedFaceSetShown;
     pushButtonSceneGraphIndexedFaceSetsHide->setEnabled(value);
-    value = processor.hasIndexedFaceSetHidden();
+    value = summary.hasIndexedFaceSetHidden;
     pushButtonSceneGraphIndexedFaceSetsShow->setEnabled(value);
 
-    value = processor.hasIndexedLineSetShown();
+    value = summary.hasIndexedLineSetShown;
     pushButtonSceneGraphIndexedLineSetsHide->setEnabled(value);
-    value = processor.hasIndexedLineSetHidden();
+    value = summary.hasIndexedLineSetHidden;
     pushButtonSceneGraphIndexedLineSetsShow->setEnabled(value);
 
-    Node* points = wrl->find("POINTS"); // should be a Shape node
-    bool  hasPoints = (points!=(Node*)0 && points->isShape());
+    Node* points = summary.points;
+    bool  hasPoints = (points!=(Node*)0);
     if(hasPoints) {
       pushButtonPointsRemove->setEnabled(true);
       bool show = points->getShow();
@@ -189,8 +193,8 @@ void GuiToolsWidget::updateState() {
       pushButtonPointsHide->setEnabled(false);
     }
 
-    Node* edges = wrl->find("EDGES"); // should be a Shape node
-    bool  hasEdges = (edges!=(Node*)0 && edges->isShape());
+    Node* edges = summary.edges;
+    bool  hasEdges = (edges!=(Node*)0);
     if(hasEdges) {
       pushButtonSceneGraphEdgesAdd->setEnabled(false);
       pushButtonSceneGraphEdgesRemove->setEnabled(true);
@@ -204,8 +208,8 @@ void GuiToolsWidget::updateState() {
       pushButtonSceneGraphEdgesHide->setEnabled(false);
     }
 
-    Node* surface    = wrl->find("SURFACE"); // should be a Shape node
-    bool  hasSurface = (surface!=(Node*)0 && surface->isShape());
+    Node* surface    = summary.surface;
+    bool  hasSurface = (surface!=(Node*)0);
     if(hasSurface) {
       pushButtonSurfaceRemove->setEnabled(true);
       bool show = surface->getShow();
@@ -259,7 +263,8 @@ void GuiToolsWidget::bboxSetDepth(int depth) {
     if(processor.hasBBox()) {
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(newDepth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(newDepth,scale,cube,occupied,0);
       _mainWindow->setSceneGraph(pWrl,false);
       _mainWindow->refresh();
     }
@@ -289,7 +294,8 @@ void GuiToolsWidget::on_spinBoxBBoxDepth_valueChanged(int depth) {
     if(processor.hasBBox()) {
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(newDepth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(newDepth,scale,cube,occupied,0);
       _mainWindow->setSceneGraph(pWrl,false);
       _mainWindow->refresh();
       updateState();
@@ -305,7 +311,8 @@ void GuiToolsWidget::on_pushButtonBBoxAdd_clicked() {
   data.setBBoxDepth(depth);
   float scale = data.getBBoxScale();
   bool  cube  = data.getBBoxCube();
-  processor.bboxAdd(depth,scale,cube);
+  bool  occupied = data.getBBoxOccupied();
+  processor.bboxAdd(depth,scale,cube,occupied,0);
   _mainWindow->setSceneGraph(pWrl,false);
   _mainWindow->refresh();
   updateState();
@@ -335,7 +342,8 @@ void GuiToolsWidget::on_editBBoxScale_returnPressed() {
       int   depth = data.getBBoxDepth();
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(depth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(depth,scale,cube,occupied,0);
       _mainWindow->setSceneGraph(data.getSceneGraph(),false);
       _mainWindow->refresh();
       updateState();
@@ -351,7 +359,8 @@ void GuiToolsWidget::on_checkBoxBBoxCube_stateChanged(int state) {
     int   depth = data.getBBoxDepth();
     float scale = data.getBBoxScale();
     bool  cube  = data.getBBoxCube();
-    processor.bboxAdd(depth,scale,cube);
+    bool  occupied = data.getBBoxOccupied();
+    processor.bboxAdd(depth,scale,cube,occupied,0);
     _mainWindow->setSceneGraph(data.getSceneGraph(),false);
     _mainWindow->refresh();
     updateState();
@@ -362,6 +371,22 @@ void GuiToolsWidget::bboxCube() {
   on_checkBoxBBoxCube_stateChanged((checkBoxBBoxCube->isChecked())?2:0);
 }
 
+void GuiToolsWidget::on_checkBoxBBoxOccupied_stateChanged(int state) {
+  GuiViewerData& data = _mainWindow->getData();
+  data.setBBoxOccupied((state!=0));
+  SceneGraphProcessor processor(*(data.getSceneGraph()));
+  if(processor.hasBBox()) {
+    int   depth    = data.getBBoxDepth();
+    float scale    = data.getBBoxScale();
+    bool  cube     = data.getBBoxCube();
+    bool  occupied = data.getBBoxOccupied();
+    processor.bboxAdd(depth,scale,cube,occupied,0);
+    _mainWindow->setSceneGraph(data.getSceneGraph(),false);
+    _mainWindow->refresh();
+    updateState();
+  }
+}
+
 void GuiToolsWidget::on_pushButtonSceneGraphEdgesAdd_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
@@ -414,6 +439,7 @@ void GuiToolsWidget::on_pushButtonSceneGraphNormalInvert_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
   if(pWrl!=(SceneGraph*)0) {
+    data.pushUndo();
     SceneGraphProcessor processor(*pWrl);
     processor.normalInvert();
     _mainWindow->setSceneGraph(pWrl,false);
@@ -426,6 +452,7 @@ void GuiToolsWidget::on_pushButtonSceneGraphNormalNone_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
   if(pWrl!=(SceneGraph*)0) {
+    data.pushUndo();
     SceneGraphProcessor processor(*pWrl);
     processor.normalClear();
     _mainWindow->setSceneGraph(pWrl,false);
@@ -438,6 +465,7 @@ void GuiToolsWidget::on_pushButtonSceneGraphNormalPerVertex_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
   if(pWrl!=(SceneGraph*)0) {
+    data.pushUndo();
     SceneGraphProcessor processor(*pWrl);
     processor.computeNormalPerVertex();
     _mainWindow->setSceneGraph(pWrl,false);
@@ -450,6 +478,7 @@ void GuiToolsWidget::on_pushButtonSceneGraphNormalPerFace_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
   if(pWrl!=(SceneGraph*)0) {
+    data.pushUndo();
     SceneGraphProcessor processor(*pWrl);
     processor.computeNormalPerFace();
     _mainWindow->setSceneGraph(pWrl,false);
@@ -462,6 +491,7 @@ void GuiToolsWidget::on_pushButtonSceneGraphNormalPerCorner_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
   if(pWrl!=(SceneGraph*)0) {
+    data.pushUndo();
     SceneGraphProcessor processor(*pWrl);
     processor.computeNormalPerCorner();
     _mainWindow->setSceneGraph(pWrl,false);
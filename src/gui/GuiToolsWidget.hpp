@@ -80,6 +80,7 @@ private slots:
   void on_pushButtonBBoxRemove_clicked();
   void on_editBBoxScale_returnPressed();
   void on_checkBoxBBoxCube_stateChanged(int satate);
+  void on_checkBoxBBoxOccupied_stateChanged(int state);
 
   // scene graph
   void on_pushButtonSceneGraphNormalNone_clicked();
@@ -44,12 +44,54 @@ GuiViewerData::GuiViewerData():
 }
 
 GuiViewerData::~GuiViewerData() {
+  clearUndo();
   if(_pWrl!=(SceneGraph*)0) delete _pWrl;
 }
 
 void GuiViewerData::setSceneGraph(SceneGraph* pWrl) {
   if(pWrl!=_pWrl) {
+    clearUndo();
     if(_pWrl!=(SceneGraph*)0) delete _pWrl;
     _pWrl = pWrl;
   }
 }
+
+void GuiViewerData::clearUndo() {
+  for(SceneGraphSnapshot* snapshot : _undo) delete snapshot;
+  for(SceneGraphSnapshot* snapshot : _redo) delete snapshot;
+  _undo.clear();
+  _redo.clear();
+}
+
+// snapshots share the arrays with the scene graph, so that only the
+// arrays modified by later operations take extra memory
+void GuiViewerData::pushUndo() {
+  if(_pWrl==(SceneGraph*)0) return;
+  for(SceneGraphSnapshot* snapshot : _redo) delete snapshot;
+  _redo.clear();
+  if(static_cast<int>(_undo.size())==_undoDepth) {
+    delete _undo.front();
+    _undo.erase(_undo.begin());
+  }
+  _undo.push_back(new SceneGraphSnapshot(*_pWrl));
+}
+
+bool GuiViewerData::undo() {
+  if(_pWrl==(SceneGraph*)0 || _undo.size()==0) return false;
+  _redo.push_back(new SceneGraphSnapshot(*_pWrl));
+  SceneGraphSnapshot* snapshot = _undo.back();
+  _undo.pop_back();
+  snapshot->restore();
+  delete snapshot;
+  return true;
+}
+
+bool GuiViewerData::redo() {
+  if(_pWrl==(SceneGraph*)0 || _redo.size()==0) return false;
+  _undo.push_back(new SceneGraphSnapshot(*_pWrl));
+  SceneGraphSnapshot* snapshot = _redo.back();
+  _redo.pop_back();
+  snapshot->restore();
+  delete snapshot;
+  return true;
+}
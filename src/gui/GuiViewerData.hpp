@@ -35,7 +35,9 @@
 #ifndef _GUI_VIEWER_DATA_HPP_
 #define _GUI_VIEWER_DATA_HPP_
 
+#include <vector>
 #include "wrl/SceneGraph.hpp"
+#include "wrl/SceneGraphSnapshot.hpp"
 
 class GuiViewerData {
 public:
@@ -69,6 +71,18 @@ public:
   void           setBBoxScale(float scale)
   { _bboxScale = (scale<0.0f)?0.0f:scale; }
 
+  // undo and redo of the operations which modify the geometry of the
+  // scene graph; pushUndo() is called before the operation, and
+  // discards the operations undone so far
+  void           pushUndo();
+  bool           undo();
+  bool           redo();
+  bool           canUndo() const
+  { return _undo.size()>0; }
+  bool           canRedo() const
+  { return _redo.size()>0; }
+  void           clearUndo();
+
 private:
 
   SceneGraph*   _pWrl;
@@ -79,6 +93,10 @@ private:
   bool          _bboxOccupied;
   float         _bboxScale;
 
+  vector<SceneGraphSnapshot*> _undo;
+  vector<SceneGraphSnapshot*> _redo;
+  static const int            _undoDepth = 16;
+
 };
 
 #endif /* _GUI_VIEWER_DATA_H_ */
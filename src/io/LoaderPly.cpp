@@ -40,21 +40,39 @@
 // DAMAGE.
 
 // #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include <iostream>
+#include <type_traits>
 
 using namespace std;
 
 #include "LoaderPly.hpp"
 #include "TokenizerFile.hpp"
 #include "TokenizerString.hpp"
+#include "NumberParser.hpp"
 #include "StrException.hpp"
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
 #include <wrl/Material.hpp>
 #include <wrl/ImageTexture.hpp>
 #include <wrl/IndexedFaceSetPly.hpp>
+#include <util/Parallel.hpp>
 
 const char* LoaderPly::_ext = "ply";
+int         LoaderPly::_nThreads = 1;
+
+//////////////////////////////////////////////////////////////////////
+// static
+void LoaderPly::setNumberOfThreads(const int nThreads) {
+  _nThreads = nThreads;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+int LoaderPly::getNumberOfThreads() {
+  return _nThreads;
+}
 
 //////////////////////////////////////////////////////////////////////
 // static
@@ -159,10 +177,35 @@ void LoaderPly::addBinaryValue
   }
 }
 
+// locale independent replacements for atoi(), atol(), strtoul() and
+// atof(), which also return 0 if the token is not a number
+
+static long _atol(string_view token) {
+  long l = 0;
+  NumberParser::parseLong(token.data(),token.data()+token.size(),l);
+  return l;
+}
+
+static unsigned long _atoul(string_view token) {
+  unsigned long ul = 0;
+  NumberParser::parseULong(token.data(),token.data()+token.size(),ul);
+  return ul;
+}
+
+static int _atoi(string_view token) {
+  return static_cast<int>(_atol(token));
+}
+
+static double _atof(string_view token) {
+  double d = 0.0;
+  NumberParser::parseDouble(token.data(),token.data()+token.size(),d);
+  return d;
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
 void LoaderPly::addAsciiValue
-(const string& token,
+(string_view token,
  const Ply::Element::Property::Type propertyType,
  void* value) {
 
@@ -171,7 +214,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::INT8:
     {
       vector<char>* valueChar= static_cast<vector<char>*>(value);
-      char v = static_cast<char>(atoi(token.c_str()));
+      char v = static_cast<char>(_atoi(token));
       valueChar->push_back(v);
     }
     break;
@@ -179,7 +222,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT8:
     {
       vector<uchar>* valueUChar= static_cast<vector<uchar>*>(value);
-      uchar v = static_cast<uchar>(atoi(token.c_str()));
+      uchar v = static_cast<uchar>(_atoi(token));
       valueUChar->push_back(v);
     }
     break;
@@ -187,7 +230,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::INT16:
     {
       vector<short>* valueShort= static_cast<vector<short>*>(value);
-      short v = static_cast<short>(atoi(token.c_str()));
+      short v = static_cast<short>(_atoi(token));
       valueShort->push_back(v);
     }
     break;
@@ -195,7 +238,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT16:
     {
       vector<ushort>* valueUShort= static_cast<vector<ushort>*>(value);
-      ushort v = static_cast<ushort>(atoi(token.c_str()));
+      ushort v = static_cast<ushort>(_atoi(token));
       valueUShort->push_back(v);
     }
     break;
@@ -203,7 +246,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::INT32:
     {
       vector<int>* valueInt= static_cast<vector<int>*>(value);
-      int v = static_cast<int>(atoi(token.c_str()));
+      int v = static_cast<int>(_atoi(token));
       valueInt->push_back(v);
     }
     break;
@@ -211,7 +254,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT32:
     {
       vector<uint>* valueUInt= static_cast<vector<uint>*>(value);
-      uint v = static_cast<uint>(atol(token.c_str()));
+      uint v = static_cast<uint>(_atoul(token));
       valueUInt->push_back(v);
     }
     break;
@@ -221,7 +264,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::FLOAT32_3:
     {
       vector<float>* valueFloat = static_cast<vector<float>*>(value);
-      float v = static_cast<float>(atof(token.c_str()));
+      float v = static_cast<float>(_atof(token));
       valueFloat->push_back(v);
     }
     break;
@@ -229,7 +272,7 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::FLOAT64:
     {
       vector<double>* valueDouble = static_cast<vector<double>*>(value);
-      double v = static_cast<double>(atof(token.c_str()));
+      double v = static_cast<double>(_atof(token));
       valueDouble->push_back(v);
     }
     break;
@@ -417,6 +460,8 @@ size_t LoaderPly::readHeader(FILE* fp, Ply& ply, const string indent) {
 
       }
     }
+    // the binary data is read directly from fp
+    ftkn.sync();
     nBytes = static_cast<size_t>(ftell(fp));
   }
 
@@ -425,6 +470,247 @@ size_t LoaderPly::readHeader(FILE* fp, Ply& ply, const string indent) {
   return nBytes;
 }
 
+//////////////////////////////////////////////////////////////////////
+// fast path of readBinaryData(), for elements whose records all have
+// the same length
+
+// a property of the element, as stored in each record of the file
+struct FixedStrideColumn {
+  Ply::Element::Property* property;
+  size_t                  offset; // of the first value in the record
+  int                     n;      // number of values per record
+  bool                    color;  // wrlMode color, stored as uchar
+};
+
+// number of values per record of a property which is not a list, and
+// their size in the file, as read by readBinaryData(); returns false
+// if the property is not supported by the fast path
+static bool _fixedLayout
+(Ply::Element::Property& property, const bool wrlMode,
+ int& n, int& nBytesValue) {
+  Ply::Element::Property::Type type = property.getPropertyType();
+  bool isFloat =
+    (type==Ply::Element::Property::Type::FLOAT     ||
+     type==Ply::Element::Property::Type::FLOAT32   ||
+     type==Ply::Element::Property::Type::FLOAT32_2 ||
+     type==Ply::Element::Property::Type::FLOAT32_3);
+  n = (type==Ply::Element::Property::Type::FLOAT32_3)?3:
+      (type==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+  nBytesValue = property.getPropertyTypeSize()/n;
+  if(wrlMode==false) return (n==1);
+  if(property.getName()=="color") {
+    nBytesValue = 1;
+    return isFloat;
+  }
+  return true;
+}
+
+// calls f() with the vector which stores the values of the property
+template <class F>
+static void _withValue(Ply::Element::Property& property, F f) {
+  void* value = property.getValue();
+  switch(property.getPropertyType()) {
+  case Ply::Element::Property::CHAR:
+  case Ply::Element::Property::INT8:
+    f(*static_cast<vector<char>*>(value));
+    break;
+  case Ply::Element::Property::UCHAR:
+  case Ply::Element::Property::UINT8:
+    f(*static_cast<vector<uchar>*>(value));
+    break;
+  case Ply::Element::Property::SHORT:
+  case Ply::Element::Property::INT16:
+    f(*static_cast<vector<short>*>(value));
+    break;
+  case Ply::Element::Property::USHORT:
+  case Ply::Element::Property::UINT16:
+    f(*static_cast<vector<ushort>*>(value));
+    break;
+  case Ply::Element::Property::INT:
+  case Ply::Element::Property::INT32:
+    f(*static_cast<vector<int>*>(value));
+    break;
+  case Ply::Element::Property::UINT:
+  case Ply::Element::Property::UINT32:
+    f(*static_cast<vector<uint>*>(value));
+    break;
+  case Ply::Element::Property::FLOAT:
+  case Ply::Element::Property::FLOAT32:
+  case Ply::Element::Property::FLOAT32_2:
+  case Ply::Element::Property::FLOAT32_3:
+    f(*static_cast<vector<float>*>(value));
+    break;
+  case Ply::Element::Property::DOUBLE:
+  case Ply::Element::Property::FLOAT64:
+    f(*static_cast<vector<double>*>(value));
+    break;
+  case Ply::Element::Property::NONE:
+    throw new StrException("unexpected NONE binary value type");
+  }
+}
+
+// appends the n values of each one of nRecords records to vec, and a
+// -1 after them if terminate is true; since all the bytes of -1 are
+// equal, swapping them afterwards does not change it
+template <class T>
+static void _readColumn
+(const char* src, const size_t stride, const size_t nRecords,
+ const int n, const bool swapBytes, const bool terminate, vector<T>& vec) {
+  size_t nValues = static_cast<size_t>(n)+((terminate)?1:0);
+  size_t nBytes  = static_cast<size_t>(n)*sizeof(T);
+  size_t i0      = vec.size();
+  vec.resize(i0+nRecords*nValues);
+  T* dst = vec.data()+i0;
+  for(size_t iRecord=0;iRecord<nRecords;iRecord++) {
+    memcpy(dst,src,nBytes);
+    if(terminate) dst[n] = static_cast<T>(-1);
+    src += stride;
+    dst += nValues;
+  }
+  if(swapBytes)
+    Endian::swapArray(vec.data()+i0,sizeof(T),nRecords*nValues);
+}
+
+static void _readColorColumn
+(const char* src, const size_t stride, const size_t nRecords,
+ const int n, vector<float>& vec) {
+  size_t i0 = vec.size();
+  vec.resize(i0+nRecords*static_cast<size_t>(n));
+  float* dst = vec.data()+i0;
+  for(size_t iRecord=0;iRecord<nRecords;iRecord++,src+=stride)
+    for(int j=0;j<n;j++)
+      *dst++ = static_cast<float>(static_cast<uchar>(src[j]))/255.0f;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+//
+// reads the records of the element in large blocks, when they all
+// have the same length; that is the case if every property has a
+// fixed size, except for at most one list with a one byte count,
+// which has the same value in all the records, such as the
+// vertex_indices list of a triangle mesh; returns the number of
+// records read, leaving fp at the beginning of the next record, for
+// readBinaryData() to read the remaining records, if any, one value
+// at a time
+
+int LoaderPly::readFixedStrideRecords
+(FILE* fp, Ply::Element& element, const bool swapBytes, const bool wrlMode) {
+
+  const int nRecords    = element.getNumberOfRecords();
+  const int nProperties = element.getNumberOfProperties();
+  if(fp==(FILE*)0 || nRecords<=0) return 0;
+
+  Ply::Element::Property* property;
+  int    iProperty,n,nBytesValue;
+  int    iList       = -1;
+  size_t countOffset = 0;
+
+  for(iProperty=0;iProperty<nProperties;iProperty++) {
+    property = element.getProperty(iProperty);
+    if(property->isList()) {
+      if(iList>=0 || property->getListTypeSize()!=1) return 0;
+      iList = iProperty;
+    } else if(_fixedLayout(*property,wrlMode,n,nBytesValue)==false) {
+      return 0;
+    } else if(iList<0) {
+      countOffset += static_cast<size_t>(n*nBytesValue);
+    }
+  }
+
+  // the list count of the first record
+  int nList = 0;
+  if(iList>=0) {
+    long fp0 = ftell(fp);
+    if(fp0<0 || fseek(fp,static_cast<long>(countOffset),SEEK_CUR)!=0)
+      return 0;
+    nList = fgetc(fp);
+    fseek(fp,fp0,SEEK_SET);
+    if(nList==EOF) return 0;
+  }
+
+  vector<FixedStrideColumn> column;
+  size_t stride = 0;
+  for(iProperty=0;iProperty<nProperties;iProperty++) {
+    property = element.getProperty(iProperty);
+    FixedStrideColumn col;
+    col.property = property;
+    col.color    = false;
+    if(iProperty==iList) {
+      stride      += 1;
+      n            = nList;
+      nBytesValue  = property->getPropertyTypeSize();
+    } else {
+      _fixedLayout(*property,wrlMode,n,nBytesValue);
+      col.color = (wrlMode && property->getName()=="color");
+    }
+    col.offset = stride;
+    col.n      = n;
+    stride    += static_cast<size_t>(n*nBytesValue);
+    column.push_back(col);
+  }
+  if(stride==0) return 0;
+
+  for(FixedStrideColumn& col:column) {
+    size_t nValues = static_cast<size_t>(col.n);
+    if(col.property->isList() && wrlMode &&
+       col.property->getName()=="coordIndex")
+      nValues++;
+    _withValue(*col.property,[&](auto& vec) {
+      vec.reserve(vec.size()+nValues*static_cast<size_t>(nRecords));
+    });
+  }
+
+  // blocks of about 1MB
+  const size_t blockRecords = max(static_cast<size_t>(1),(1<<20)/stride);
+  vector<char> block(blockRecords*stride);
+
+  int iRecord = 0;
+  while(iRecord<nRecords) {
+    size_t nRead = min(blockRecords,static_cast<size_t>(nRecords-iRecord));
+    size_t nBytes = fread(block.data(),1,nRead*stride,fp);
+    // on a short read, or if the list count changes, the records left
+    // are read by readBinaryData()
+    size_t nDone = nBytes/stride;
+    if(iList>=0) {
+      const char* count = block.data()+column[iList].offset-1;
+      size_t i;
+      for(i=0;i<nDone;i++,count+=stride)
+        if(static_cast<uchar>(*count)!=nList) break;
+      nDone = i;
+    }
+
+    for(FixedStrideColumn& col:column) {
+      const char* src = block.data()+col.offset;
+      if(col.color) {
+        vector<float>* value =
+          static_cast<vector<float>*>(col.property->getValue());
+        _readColorColumn(src,stride,nDone,col.n,*value);
+      } else if(col.property->isList()) {
+        bool coordIndex = (wrlMode && col.property->getName()=="coordIndex");
+        if(coordIndex==false)
+          for(size_t i=0;i<nDone;i++)
+            col.property->pushBackList(nList);
+        _withValue(*col.property,[&](auto& vec) {
+          _readColumn(src,stride,nDone,col.n,swapBytes,coordIndex,vec);
+        });
+      } else {
+        _withValue(*col.property,[&](auto& vec) {
+          _readColumn(src,stride,nDone,col.n,swapBytes,false,vec);
+        });
+      }
+    }
+
+    iRecord += static_cast<int>(nDone);
+    if(nDone<nRead) {
+      fseek(fp,-static_cast<long>(nBytes-nDone*stride),SEEK_CUR);
+      break;
+    }
+  }
+
+  return iRecord;
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
 size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
@@ -505,8 +791,12 @@ size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
       //          .arg(indent.c_str())
       //          .arg(nRecords));
 
+      // records of equal length are read in blocks; those left, if
+      // any, are read here one value at a time
+      iRecord = readFixedStrideRecords(fp,*element,swapBytes,wrlMode);
+
       k0 = 0;
-      for(iRecord=0;iRecord<nRecords;iRecord++) {
+      for(;iRecord<nRecords;iRecord++) {
         nBytesRecord = 0;
         for(iProperty=0;iProperty<nProperties;iProperty++) {
 
@@ -655,6 +945,81 @@ size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
   return nBytesData;
 }
 
+//////////////////////////////////////////////////////////////////////
+// static
+//
+// parses the tokens of one line as the values of a record, and appends
+// them to the properties, which are those of the element, or copies of
+// them made by readAsciiDataParallel()
+
+void LoaderPly::readAsciiRecord
+(Tokenizer& stkn, vector<Ply::Element::Property*>& elementProperty,
+ const int iRecord, const bool wrlMode) {
+
+  Ply::Element::Property* property;
+  Ply::Element::Property::Type propertyType;
+  void* value;
+  int i,iProperty,nList;
+  const int nProperties = static_cast<int>(elementProperty.size());
+
+  for(iProperty=0;iProperty<nProperties;iProperty++) {
+
+    property     = elementProperty[iProperty];
+    const string& propertyName = property->getName();
+    propertyType = property->getPropertyType();
+  
+    if(property->isList()==true) {
+ 
+      nList = 0;
+
+      if(stkn.next()==false) {
+        char s[128];
+        snprintf(s,128,"end of line in property record %d",iRecord);
+        throw new StrException(string(s));
+      }
+
+      nList = _atoi(stkn.view());
+
+      if(wrlMode==false || propertyName!="coordIndex")
+        property->pushBackList(nList);
+ 
+      value = property->getValue();
+  
+       for(i=0;i<nList;i++) {
+         if(stkn.next()==false) {
+           char s[128];
+           snprintf(s,128,"end of line in property record %d",iRecord);
+           throw new StrException(string(s));
+         }
+         addAsciiValue(stkn.view(),propertyType,value);
+       }
+
+       if(wrlMode && propertyName=="coordIndex")
+         static_cast<vector<int>*>(value)->push_back(-1);
+
+    } else /* if(property.isList()==false) */ {
+
+      value = property->getValue();
+ 
+      int n =
+        (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+        (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+
+      while(--n>=0) {
+        if(stkn.next()==false) {
+          char s[128];
+          snprintf(s,128,"end of line in property record %d",iRecord);
+          throw new StrException(string(s));
+        }
+        addAsciiValue(stkn.view(),propertyType,value);
+        if(wrlMode && propertyName=="color") {
+            static_cast<vector<float>*>(value)->back() /= 255.0;
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
 size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
@@ -674,12 +1039,9 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
     //          .arg(nElements));
 
     Ply::Element* element;
-    Ply::Element::Property* property;
-    // Ply::Element::Property::Type listType = Ply::Element::Property::Type::NONE;
-    Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
-    void* value;
-    string line,name,propertyName,token;
-    int i,iElement,iProperty,iRecord,k0,k1,nList,nProperties,nRecords;
+    vector<Ply::Element::Property*> elementProperty;
+    string name;
+    int iElement,iProperty,iRecord,k0,k1,nProperties,nRecords;
 
     bool wrlMode = ply.getWrlMode();
 
@@ -701,6 +1063,10 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
        //          .arg(indent.c_str())
        //          .arg(nRecords));
 
+       elementProperty.resize(static_cast<size_t>(nProperties));
+       for(iProperty=0;iProperty<nProperties;iProperty++)
+         elementProperty[iProperty] = element->getProperty(iProperty);
+
        k0 = 0;
        for(iRecord=0;iRecord<nRecords;iRecord++) {
 
@@ -711,63 +1077,7 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
           }
 
           TokenizerString stkn(ftkn);
-
-          for(iProperty=0;iProperty<nProperties;iProperty++) {
-
-            property     = element->getProperty(iProperty);
-            propertyName = property->getName();
-            propertyType = property->getPropertyType();
-  
-            if(property->isList()==true) {
- 
-              nList = 0;
-
-              if(stkn.get()==false) {
-                char s[128];
-                snprintf(s,128,"end of line in property record %d",iRecord);
-                throw new StrException(string(s));
-              }
-
-              nList = atoi(stkn.c_str());
-
-              if(wrlMode==false || propertyName!="coordIndex")
-                property->pushBackList(nList);
- 
-              value = property->getValue();
-  
-               for(i=0;i<nList;i++) {
-                 if(stkn.get()==false) {
-                   char s[128];
-                   snprintf(s,128,"end of line in property record %d",iRecord);
-                   throw new StrException(string(s));
-                 }
-                 addAsciiValue(stkn,propertyType,value);
-               }
-
-               if(wrlMode && propertyName=="coordIndex")
-                 static_cast<vector<int>*>(value)->push_back(-1);
-
-            } else /* if(property.isList()==false) */ {
-
-              value = property->getValue();
- 
-              int n =
-                (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-                (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-
-              while(--n>=0) {
-                if(stkn.get()==false) {
-                  char s[128];
-                  snprintf(s,128,"end of line in property record %d",iRecord);
-                  throw new StrException(string(s));
-                }
-                addAsciiValue(stkn,propertyType,value);
-                if(wrlMode && propertyName=="color") {
-                    static_cast<vector<float>*>(value)->back() /= 255.0;
-                }
-              }
-            }
-          }
+          readAsciiRecord(stkn,elementProperty,iRecord,wrlMode);
 
           // report progress
           k1 = (10*(iRecord+1))/nRecords;
@@ -781,6 +1091,7 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
       } // for(iRecord=0;iRecord<nRecords;iRecord++)
     } // for(iElement=0;iElement<nElements;iElement++)
 
+    ftkn.sync();
     long fp1 = ftell(fp);
     nBytes = static_cast<size_t>(fp1-fp0);
   }
@@ -788,6 +1099,218 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
   return nBytes;
 }
 
+//////////////////////////////////////////////////////////////////////
+// static
+//
+// produces the same result as readAsciiData(), using nThreads threads;
+// the data is read in large windows of whole lines, the line ends of
+// each window are found in parallel, and the lines are assigned in
+// order to the records of the elements; the lines of each element are
+// split into chunks, and each chunk is parsed by readAsciiRecord() into
+// its own copy of the element properties; the copies are concatenated
+// in parallel into the element properties, at positions given by
+// prefix sums of their sizes, and the prefix sums of the list lengths
+// are added to the list offsets of the copies
+
+size_t LoaderPly::readAsciiDataParallel
+(FILE* fp, Ply& ply, const int nThreads, const string indent) {
+
+  (void)indent;
+
+  if(fp==nullptr) return 0;
+
+  typedef Ply::Element::Property Property;
+
+  const size_t windowSize = 1<<26;
+  const bool   wrlMode    = ply.getWrlMode();
+  const int    nElements  = ply.getNumberOfElements();
+
+  Ply::Element*             element;
+  vector<Property*>         elementProperty;
+  vector<vector<Property*>> chunkProperty;
+  vector<char>              window;
+  vector<int>               newline;
+  vector<int>               count;
+  size_t nBytes = 0, carry = 0, size, end, nRead;
+  int    iElement, iRecord = 0, iProperty, nProperties;
+  int    iLine, nLines, nRanges, nChunks, k, n;
+  bool   eof = false;
+
+  // reserve space for the properties which have the same number of
+  // values in all the records
+  for(iElement=0;iElement<nElements;iElement++) {
+    element = ply.getElement(iElement);
+    size_t nRecords = static_cast<size_t>(max(0,element->getNumberOfRecords()));
+    for(iProperty=0;iProperty<element->getNumberOfProperties();iProperty++) {
+      Property* property = element->getProperty(iProperty);
+      if(property->isList()) continue;
+      Property::Type type = property->getPropertyType();
+      size_t nValues =
+        (type==Property::Type::FLOAT32_3)?3:(type==Property::Type::FLOAT32_2)?2:1;
+      _withValue(*property,[&](auto& vec) {
+        vec.reserve(vec.size()+nValues*nRecords);
+      });
+    }
+  }
+
+  iElement = 0;
+  while(iElement<nElements && ply.getElement(iElement)->getNumberOfRecords()<=0)
+    iElement++;
+
+  while(iElement<nElements) {
+
+    // the window starts with the incomplete line left by the previous
+    // one, if any, and ends with the last complete line read, or at
+    // the end of the file; a null character follows the last line
+    window.resize(carry+windowSize+1);
+    nRead = fread(window.data()+carry,1,windowSize,fp);
+    eof   = (feof(fp)!=0 || ferror(fp)!=0);
+    size  = carry+nRead;
+    window[size] = '\0';
+    end = size;
+    if(eof==false) {
+      while(end>carry && window[end-1]!='\n') end--;
+      if(end==carry) {
+        // no line ends in the data read; read more
+        carry = size;
+        continue;
+      }
+    }
+
+    // find the line ends
+    nRanges = Parallel::getNumberOfRanges(nThreads,static_cast<int>(end));
+    count.assign(static_cast<size_t>(nRanges)+1,0);
+    Parallel::forRanges(nThreads,static_cast<int>(end),[&](int k, int b0, int b1) {
+        const char* c = window.data()+b0;
+        const char* c1 = window.data()+b1;
+        while((c=static_cast<const char*>(memchr(c,'\n',c1-c)))!=nullptr) {
+          count[k+1]++;
+          if(++c==c1) break;
+        }
+      });
+    for(k=0;k<nRanges;k++) count[k+1] += count[k];
+    newline.resize(static_cast<size_t>(count[nRanges]));
+    Parallel::forRanges(nThreads,static_cast<int>(end),[&](int k, int b0, int b1) {
+        int j = count[k];
+        for(int b=b0;b<b1;b++)
+          if(window[b]=='\n') newline[j++] = b;
+      });
+    // a last line which does not end in a newline
+    if(end>0 && window[end-1]!='\n') newline.push_back(static_cast<int>(end));
+    nLines = static_cast<int>(newline.size());
+
+    // parse the lines of each element
+    for(iLine=0;iLine<nLines && iElement<nElements;) {
+
+      element     = ply.getElement(iElement);
+      nProperties = element->getNumberOfProperties();
+      n           = min(nLines-iLine,element->getNumberOfRecords()-iRecord);
+
+      elementProperty.resize(static_cast<size_t>(nProperties));
+      for(iProperty=0;iProperty<nProperties;iProperty++)
+        elementProperty[iProperty] = element->getProperty(iProperty);
+
+      nChunks = Parallel::getNumberOfRanges(nThreads,n);
+      chunkProperty.assign(static_cast<size_t>(nChunks),vector<Property*>());
+      for(k=0;k<nChunks;k++) {
+        for(Property* property:elementProperty) {
+          chunkProperty[k].push_back
+            (new Property(property->getName(),property->isList(),
+                          property->getListType(),
+                          property->getPropertyType(),*element));
+        }
+      }
+
+      vector<string> error(static_cast<size_t>(nChunks));
+      Parallel::forRanges(nThreads,n,[&](int k, int i0, int i1) {
+          try {
+            for(int i=i0;i<i1;i++) {
+              int b0 = (iLine+i==0)?0:newline[iLine+i-1]+1;
+              int b1 = newline[iLine+i];
+              if(b1==b0) {
+                char s[128];
+                snprintf(s,128,"found empty record %d",iRecord+i);
+                throw new StrException(string(s));
+              }
+              TokenizerString stkn(window.data()+b0,static_cast<size_t>(b1-b0));
+              readAsciiRecord(stkn,chunkProperty[k],iRecord+i,wrlMode);
+            }
+          } catch(StrException* e) {
+            error[k] = e->what();
+            delete e;
+          }
+        });
+
+      for(k=0;k<nChunks && error[k].empty();k++);
+      if(k<nChunks) {
+        for(vector<Property*>& chunk:chunkProperty)
+          for(Property* property:chunk) delete property;
+        throw new StrException(error[k]);
+      }
+
+      // concatenate the chunks
+      vector<size_t> base(static_cast<size_t>(nChunks)+1);
+      vector<int>    offset(static_cast<size_t>(nChunks)+1);
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        Property* property = elementProperty[iProperty];
+        _withValue(*property,[&](auto& vec) {
+            typedef typename std::remove_reference<decltype(vec)>::type Vector;
+            base[0] = vec.size();
+            for(k=0;k<nChunks;k++)
+              base[k+1] = base[k]+
+                static_cast<Vector*>(chunkProperty[k][iProperty]->getValue())->size();
+            vec.resize(base[nChunks]);
+            Parallel::forTasks(nThreads,nChunks,[&](int k) {
+                Vector& src = *static_cast<Vector*>(chunkProperty[k][iProperty]->getValue());
+                std::copy(src.begin(),src.end(),vec.begin()+base[k]);
+              });
+          });
+        if(property->isList()) {
+          vector<int>& first = property->getFirst();
+          base[0]   = first.size();
+          offset[0] = first.back();
+          for(k=0;k<nChunks;k++) {
+            vector<int>& chunkFirst = chunkProperty[k][iProperty]->getFirst();
+            base[k+1]   = base[k]+chunkFirst.size()-1;
+            offset[k+1] = offset[k]+chunkFirst.back();
+          }
+          first.resize(base[nChunks]);
+          Parallel::forTasks(nThreads,nChunks,[&](int k) {
+              vector<int>& chunkFirst = chunkProperty[k][iProperty]->getFirst();
+              for(size_t j=1;j<chunkFirst.size();j++)
+                first[base[k]+j-1] = offset[k]+chunkFirst[j];
+            });
+        }
+      }
+      for(vector<Property*>& chunk:chunkProperty)
+        for(Property* property:chunk) delete property;
+
+      iLine   += n;
+      iRecord += n;
+      if(iRecord==element->getNumberOfRecords()) {
+        iRecord = 0;
+        do iElement++;
+        while(iElement<nElements && ply.getElement(iElement)->getNumberOfRecords()<=0);
+      }
+    }
+
+    // bytes up to the end of the last line parsed
+    if(iLine>0)
+      nBytes += static_cast<size_t>(min(newline[iLine-1]+1,static_cast<int>(end)));
+
+    if(iElement<nElements && eof) {
+      char s[128]; snprintf(s,128,"found empty record %d",iRecord);
+      throw new StrException(string(s));
+    }
+
+    // keep the incomplete line for the next window
+    carry = size-end;
+    memmove(window.data(),window.data()+end,carry);
+  }
+
+  return nBytes;
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
 bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
@@ -819,7 +1342,9 @@ bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
 
     if(ply.getDataType()==Ply::DataType::ASCII) {
       // continue reading ascii data from the same FileInputStream
-      nBytesData = readAsciiData(fp,ply,indent+"  ");
+      nBytesData = (_nThreads==1)?
+        readAsciiData(fp,ply,indent+"  "):
+        readAsciiDataParallel(fp,ply,_nThreads,indent+"  ");
 
       // APP->log(QString("%1  nBytesData(ASCII) = %2")
       //          .arg(indent.c_str())
@@ -43,6 +43,7 @@
 #define _LOADER_PLY_HPP_
 
 #include "Loader.hpp"
+#include "Tokenizer.hpp"
 #include <util/Endian.hpp>
 #include <wrl/Ply.hpp>
 #include <wrl/SceneGraph.hpp>
@@ -52,6 +53,7 @@ class LoaderPly : public Loader {
 private:
 
   const static char* _ext;
+  static int         _nThreads;
 
 public:
 
@@ -63,6 +65,11 @@ public:
 
   static bool load(const char* filename, Ply & ply, const string indent="");
 
+  // number of threads used to parse ascii data; 1, the default, selects
+  // the serial loader, and <=0 all the cores
+  static void setNumberOfThreads(const int nThreads);
+  static int  getNumberOfThreads();
+
 private:
 
   static Ply::DataType systemEndian();
@@ -75,13 +82,23 @@ private:
    void* value);
   
   static void addAsciiValue
-  (const string& token,
+  (string_view token,
    const Ply::Element::Property::Type propertyType,
    void* value);
   
   static size_t readHeader(FILE* fp, Ply& ply, const string indent="");
   static size_t readBinaryData(FILE* fp, Ply& ply, const string indent="");
+  static int    readFixedStrideRecords
+                (FILE* fp, Ply::Element& element,
+                 const bool swapBytes, const bool wrlMode);
   static size_t readAsciiData(FILE* fp, Ply& ply, const string indent="");
+  static void   readAsciiRecord
+                (Tokenizer& stkn,
+                 vector<Ply::Element::Property*>& elementProperty,
+                 const int iRecord, const bool wrlMode);
+  static size_t readAsciiDataParallel
+                (FILE* fp, Ply& ply, const int nThreads,
+                 const string indent="");
 
 };
 
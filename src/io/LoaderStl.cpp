@@ -41,6 +41,8 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <algorithm>
+#include <climits>
 #include <cstdio>
 #include <cstring>
 #include "TokenizerFile.hpp"
@@ -51,11 +53,31 @@
 #include "wrl/Appearance.hpp"
 #include "wrl/Material.hpp"
 #include "wrl/IndexedFaceSet.hpp"
+#include "wrl/SceneGraphProcessor.hpp"
+#include "util/Endian.hpp"
 
 // reference
 // https://en.wikipedia.org/wiki/STL_(file_format)
 
 const char* LoaderStl::_ext = "stl";
+float       LoaderStl::_weldTolerance = -1.0f;
+int         LoaderStl::_nThreads = 1;
+
+void LoaderStl::setWeldTolerance(const float tolerance) {
+  _weldTolerance = tolerance;
+}
+
+float LoaderStl::getWeldTolerance() {
+  return _weldTolerance;
+}
+
+void LoaderStl::setNumberOfThreads(const int nThreads) {
+  _nThreads = nThreads;
+}
+
+int LoaderStl::getNumberOfThreads() {
+  return _nThreads;
+}
 
 IndexedFaceSet* LoaderStl::_initializeSceneGraph
 (const char* filename, SceneGraph& wrl) {
@@ -102,21 +124,36 @@ bool LoaderStl::_loadFacetAscii
     return true;
 }
 
-bool LoaderStl::_loadFacetBinary
-(FILE* fp, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3, uint16_t* abc) {
-
-  if(fread(&(n[0]),1,12,fp)<12)
-    throw new StrException("unable to read normal vector");
-  if(fread(&(v1[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 0");
-  if(fread(&(v2[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 1");
-  if(fread(&(v3[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 2");
-  if(fread(abc,1,2,fp)<2)
-    throw new StrException("unable to read atribute byte count");
-
-  return true;
+void LoaderStl::_loadFacetsBinary
+(FILE* fp, const uint32_t nTriangles,
+ vector<float>& normal, vector<float>& coord, vector<int>& coordIndex) {
+  // each facet is a normal vector, three vertices, and an attribute
+  // byte count, which is ignored; all little endian
+  const size_t nT        = nTriangles;
+  const size_t blockSize = 1<<14;
+  normal.resize(3*nT);
+  coord.resize(9*nT);
+  coordIndex.resize(4*nT);
+  vector<char> block(50*min(nT,blockSize));
+  bool swapBytes = !Endian::isLittleEndianSystem();
+  for(size_t iT0=0;iT0<nT;iT0+=blockSize) {
+    size_t n = min(blockSize,nT-iT0);
+    if(fread(block.data(),50,n,fp)<n)
+      throw new StrException("unable to read facets");
+    for(size_t i=0;i<n;i++) {
+      const char* facet = block.data()+50*i;
+      size_t iT = iT0+i;
+      memcpy(&normal[3*iT],facet,12);
+      memcpy(&coord[9*iT],facet+12,36);
+      int  iV = static_cast<int>(3*iT);
+      int* ci = &coordIndex[4*iT];
+      ci[0] = iV; ci[1] = iV+1; ci[2] = iV+2; ci[3] = -1;
+    }
+    if(swapBytes) {
+      Endian::swapArray(&normal[3*iT0],4,3*n);
+      Endian::swapArray(&coord[9*iT0],4,9*n);
+    }
+  }
 }
 
 bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
@@ -145,6 +182,20 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       uint32_t nTriangles = 0;
       if(fread(&nTriangles,1,4,fp)<4)
         throw new StrException("unable to read number of triangles");
+      if(!Endian::isLittleEndianSystem())
+        Endian::swapArray(&nTriangles,4,1);
+
+      // vertex indices have to fit in an int
+      if(nTriangles>static_cast<uint32_t>((INT_MAX-2)/3))
+        throw new StrException("too many triangles");
+      // reject truncated files before allocating the arrays
+      long pos = ftell(fp);
+      if(pos>=0 && fseek(fp,0,SEEK_END)==0) {
+        long end = ftell(fp);
+        if(end>=0 && static_cast<unsigned long>(end-pos)<50UL*nTriangles)
+          throw new StrException("file too short for the number of triangles");
+        fseek(fp,pos,SEEK_SET);
+      }
 
       IndexedFaceSet* ifs = _initializeSceneGraph(filename,wrl);
       // get references to the coordIndex, coord, and normal arrays
@@ -154,32 +205,8 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       // 6) set the normalPerVertex variable to false (i.e., normals per face)  
       ifs->setNormalPerVertex(false);
 
-      int   iV0,iV1,iV2,iT;
-      Vec3f n,v1,v2,v3;
-      uint16_t abc; // attribute byte count
-        for(iT=0;iT<nTriangles;iT++) {
-        _loadFacetBinary(fp,n,v1,v2,v3,&abc);
-        normal.push_back(n[0]);
-        normal.push_back(n[1]);
-        normal.push_back(n[2]);
-        iV0 = static_cast<int>(coord.size()/3);
-        coord.push_back(v1[0]);
-        coord.push_back(v1[1]);
-        coord.push_back(v1[2]);
-        iV1 = static_cast<int>(coord.size()/3);
-        coord.push_back(v2[0]);
-        coord.push_back(v2[1]);
-        coord.push_back(v2[2]);
-        iV2 = static_cast<int>(coord.size()/3);
-        coord.push_back(v3[0]);
-        coord.push_back(v3[1]);
-        coord.push_back(v3[2]);
-        coordIndex.push_back(iV0);
-        coordIndex.push_back(iV1);
-        coordIndex.push_back(iV2);
-        coordIndex.push_back(-1);
-      }
-      
+      _loadFacetsBinary(fp,nTriangles,normal,coord,coordIndex);
+
       success = true;
 
       fclose(fp);
@@ -238,6 +265,11 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       // close the file (this statement may not be reached)
       fclose(fp);
     }
+
+    if(_weldTolerance>=0.0f) {
+      SceneGraphProcessor processor(wrl);
+      processor.weldVertices(_weldTolerance,_nThreads);
+    }
  
   } catch(StrException* e) { 
 
@@ -48,6 +48,8 @@ class LoaderStl : public Loader {
 private:
 
   const static char* _ext;
+  static float       _weldTolerance;
+  static int         _nThreads;
 
 public:
 
@@ -57,6 +59,16 @@ public:
   bool  load(const char* filename, SceneGraph& wrl);
   const char* ext() const { return _ext; }
 
+  // the vertices of the loaded IndexedFaceSet are welded, as in
+  // SceneGraphProcessor::weldVertices(), if tolerance>=0; 0 merges only
+  // identical vertices, and the default, -1, keeps three separate
+  // vertices per facet
+  static void  setWeldTolerance(const float tolerance);
+  static float getWeldTolerance();
+  // number of threads used to weld the vertices; <=0 for all the cores
+  static void  setNumberOfThreads(const int nThreads);
+  static int   getNumberOfThreads();
+
 private:
 
   IndexedFaceSet* _initializeSceneGraph(const char* filename, SceneGraph& wrl);
@@ -64,8 +76,11 @@ private:
   bool _loadFacetAscii
   (TokenizerFile& tkn, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3);
 
-  bool _loadFacetBinary
-  (FILE* fp, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3, uint16_t* abc);
+  // reads the nTriangles 50-byte facets which follow the binary header
+  // in blocks, straight into the normal and coord arrays
+  void _loadFacetsBinary
+  (FILE* fp, const uint32_t nTriangles,
+   vector<float>& normal, vector<float>& coord, vector<int>& coordIndex);
 
 };
 
@@ -34,6 +34,7 @@
 
 #include <stdio.h>
 #include "TokenizerFile.hpp"
+#include "NumberParser.hpp"
 #include "LoaderWrl.hpp"
 #include "StrException.hpp"
 
@@ -54,18 +55,24 @@ bool LoaderWrl::loadSceneGraph(TokenizerFile& tkn, SceneGraph& wrl) {
       wrl.addChild(g);
       loadGroup(tkn,*g);
       g->setName(name);
+      define(name,g);
       name = "";
     } else if(tkn.equals("Transform")) {
       Transform* t = new Transform();
       wrl.addChild(t);
       loadTransform(tkn,*t);
       t->setName(name);
+      define(name,t);
       name = "";
     } else if(tkn.equals("Shape")) {
       Shape* s = new Shape();
       wrl.addChild(s);
       loadShape(tkn,*s);
       s->setName(name);
+      define(name,s);
+      name = "";
+    } else if(tkn.equals("USE")) {
+      wrl.addChild(loadShapeUse(tkn));
       name = "";
     } else if(tkn.equals("")) {
       break;
@@ -187,18 +194,24 @@ bool LoaderWrl::loadChildren(TokenizerFile& tkn, Group& group) {
       group.addChild(g);
       loadGroup(tkn,*g);
       g->setName(name);
+      define(name,g);
       name = "";
     } else if(tkn.equals("Transform")) {
       Transform* t = new Transform();
       group.addChild(t);
       loadTransform(tkn,*t); 
       t->setName(name);
+      define(name,t);
       name = "";
    } else if(tkn.equals("Shape")) {
       Shape* s = new Shape();
       group.addChild(s);
       loadShape(tkn,*s);
       s->setName(name);
+      define(name,s);
+      name = "";
+    } else if(tkn.equals("USE")) {
+      group.addChild(loadShapeUse(tkn));
       name = "";
     } else if(tkn.equals("]")) {
       success = true;
@@ -216,8 +229,8 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
   //   SFNode geometry   NULL
   // }
 
-  // TODO Mon Nov 12 10:22:28 2012
-  // implement DEF name for appearance and geometry nodes
+  // the appearance and geometry nodes defined with DEF are shared by
+  // the Shapes which refer to them with USE
 
   string name    = "";
   bool   success = false;
@@ -225,6 +238,13 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
   while(success==false && tkn.get()) {
     if(tkn.equals("appearance")) {
       tkn.get("expecting appearance node");
+      if(tkn.equals("USE")) {
+        Node* node = loadUse(tkn);
+        if(node->isAppearance()==false)
+          throw new StrException("expecting Appearance after USE");
+        shape.setAppearance(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -234,11 +254,19 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
         throw new StrException("expecting Appearance");
       Appearance* a = new Appearance();
       a->setName(name);
+      define(name,a);
       name = "";
       shape.setAppearance(a);
       loadAppearance(tkn,*a);
     } else if(tkn.equals("geometry")) {
       tkn.get("expecting geometry node");
+      if(tkn.equals("USE")) {
+        Node* node = loadUse(tkn);
+        if(node->isIndexedFaceSet()==false && node->isIndexedLineSet()==false)
+          throw new StrException("found unexpected geometry node after USE");
+        shape.setGeometry(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -247,12 +275,14 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
       if(tkn.equals("IndexedFaceSet")) {
         IndexedFaceSet* ifs = new IndexedFaceSet();
         ifs->setName(name);
+        define(name,ifs);
         name = "";
         shape.setGeometry(ifs);
         loadIndexedFaceSet(tkn,*ifs);
       } else if(tkn.equals("IndexedLineSet")) {
         IndexedLineSet* ils = new IndexedLineSet();
         ils->setName(name);
+        define(name,ils);
         name = "";
         shape.setGeometry(ils);
         loadIndexedLineSet(tkn,*ils);
@@ -276,8 +306,8 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
   //   // SFNode textureTransform NULL
   // }
 
-  // TODO Mon Nov 12 10:22:28 2012
-  // implement DEF name for matrial and texture nodes
+  // the material and texture nodes defined with DEF are shared by the
+  // Appearances which refer to them with USE
 
   string name    = "";
   bool   success = false;
@@ -285,6 +315,13 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
   while(success==false && tkn.get()) {
     if(tkn.equals("material")) {
       tkn.get("expecting material node");
+      if(tkn.equals("USE")) {
+        Node* node = loadUse(tkn);
+        if(node->isMaterial()==false)
+          throw new StrException("expecting Material after USE");
+        appearance.setMaterial(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -294,11 +331,19 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
         throw new StrException("expecting Material");
       Material* m = new Material();
       m->setName(name);
+      define(name,m);
       name = "";
       appearance.setMaterial(m);
       loadMaterial(tkn,*m);
     } else if(tkn.equals("texture")) {
       tkn.get("expecting Texture node");
+      if(tkn.equals("USE")) {
+        Node* node = loadUse(tkn);
+        if(node->isImageTexture()==false)
+          throw new StrException("found unexpected Texture node after USE");
+        appearance.setTexture(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -307,6 +352,7 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
       if(tkn.equals("ImageTexture")) {
         ImageTexture* it = new ImageTexture();
         it->setName(name);
+        define(name,it);
         name = "";
         appearance.setTexture(it);
         loadImageTexture(tkn,*it);
@@ -439,70 +485,26 @@ bool LoaderWrl::loadIndexedFaceSet(TokenizerFile& tkn, IndexedFaceSet& ifs) {
     if(tkn.equals("color")) {
       //   SFNode  
       vector<float>& _color = ifs.getColor();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("Color")==false)
-        throw new StrException("expecting Color");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("color")==false)
-        throw new StrException("expecting color");
-      if(loadVecFloat(tkn,_color)==false)
+      if(loadVecFloatNode(tkn,_color,"Color","color")==false)
         throw new StrException("loading IndexedFaceSet color field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("coord")) {
       //   SFNode  
       vector<float>& _coord = ifs.getCoord();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("Coordinate")==false)
-        throw new StrException("expecting Coordinate");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("point")==false)
-        throw new StrException("expecting point");
-      if(loadVecFloat(tkn,_coord)==false)
+      if(loadVecFloatNode(tkn,_coord,"Coordinate","point")==false)
         throw new StrException("loading IndexedFaceSet coord field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("normal")) {
       //   SFNode  
       vector<float>& _normal = ifs.getNormal();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("Normal")==false)
-        throw new StrException("expecting Normal");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("vector")==false)
-        throw new StrException("expecting vector");
-      if(loadVecFloat(tkn,_normal)==false)
+      if(loadVecFloatNode(tkn,_normal,"Normal","vector")==false)
         throw new StrException("loading IndexedFaceSet normal field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("texCoord")) {
       //   SFNode  
       vector<float>& _texCoord = ifs.getTexCoord();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("TextureCoordinate")==false)
-        throw new StrException("expecting TextureCoordinate");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("point")==false)
-        throw new StrException("expecting point");
-      if(loadVecFloat(tkn,_texCoord)==false)
+      if(loadVecFloatNode(tkn,_texCoord,"TextureCoordinate","point")==false)
         throw new StrException("loading IndexedFaceSet texCoord field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("ccw")) {
       //   SFBool
@@ -579,36 +581,14 @@ bool LoaderWrl::loadIndexedLineSet(TokenizerFile& tkn, IndexedLineSet& ifs) {
     if(tkn.equals("color")) {
       //   SFNode  
       vector<float>& _color = ifs.getColor();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("Color")==false)
-        throw new StrException("expecting Color");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("color")==false)
-        throw new StrException("expecting color");
-      if(loadVecFloat(tkn,_color)==false)
+      if(loadVecFloatNode(tkn,_color,"Color","color")==false)
         throw new StrException("loading IndexedLineSet color field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("coord")) {
       //   SFNode  
       vector<float>& _coord = ifs.getCoord();
-
-      // if DEF name found, skip and ignore ??
-
-      if(tkn.expecting("Coordinate")==false)
-        throw new StrException("expecting Coordinate");
-      if(tkn.expecting("{")==false)
-        throw new StrException("expecting \"{\"");
-      if(tkn.expecting("point")==false)
-        throw new StrException("expecting point");
-      if(loadVecFloat(tkn,_coord)==false)
+      if(loadVecFloatNode(tkn,_coord,"Coordinate","point")==false)
         throw new StrException("loading IndexedLineSet coord field");
-      if(tkn.expecting("}")==false)
-        throw new StrException("expecting \"}\"");
 
     } else if(tkn.equals("colorIndex")) {
       //   MFInt32 
@@ -634,17 +614,85 @@ bool LoaderWrl::loadIndexedLineSet(TokenizerFile& tkn, IndexedLineSet& ifs) {
   return success;
 }
 
+void LoaderWrl::define(const string& name, Node* node) {
+  if(name!="") _def[name] = node;
+}
+
+Node* LoaderWrl::loadUse(TokenizerFile& tkn) {
+  tkn.get("missing token after USE");
+  map<string,Node*>::iterator i = _def.find(tkn);
+  if(i==_def.end()) throw new StrException("USE of undefined node");
+  return i->second;
+}
+
+// only Shapes can be instanced in a list of children; the new Shape
+// shares the appearance and geometry of the one defined with the name
+Shape* LoaderWrl::loadShapeUse(TokenizerFile& tkn) {
+  Node* node = loadUse(tkn);
+  if(node->isShape()==false)
+    throw new StrException("USE of grouping nodes is not supported");
+  Shape* shape = (Shape*)node;
+  Shape* s = new Shape();
+  if(shape->getAppearance()!=(Node*)0)
+    s->setAppearance(shape->getAppearance());
+  if(shape->getGeometry()!=(Node*)0)
+    s->setGeometry(shape->getGeometry());
+  return s;
+}
+
+// Coordinate, Normal, Color and TextureCoordinate nodes are stored as
+// arrays of their IndexedFaceSet or IndexedLineSet, so that USE copies
+// the values of the node defined with the name
+bool LoaderWrl::loadVecFloatNode
+(TokenizerFile& tkn, vector<float>& vec, const char* type, const char* field) {
+  tkn.get("expecting node");
+  if(tkn.equals("USE")) {
+    tkn.get("missing token after USE");
+    map<string,pair<string,vector<float>*> >::iterator i = _defVec.find(tkn);
+    if(i==_defVec.end()) throw new StrException("USE of undefined node");
+    if(i->second.first!=type)
+      throw new StrException(string("expecting ")+type+" after USE");
+    vec = *(i->second.second);
+    return true;
+  }
+  string name = "";
+  if(tkn.equals("DEF")) {
+    tkn.get("missing token after DEF");
+    name = tkn;
+    tkn.get("missing node token");
+  }
+  if(tkn.equals(type)==false)
+    throw new StrException(string("expecting ")+type);
+  if(tkn.expecting("{")==false)
+    throw new StrException("expecting \"{\"");
+  if(tkn.expecting(field)==false)
+    throw new StrException(string("expecting ")+field);
+  if(loadVecFloat(tkn,vec)==false)
+    return false;
+  if(tkn.expecting("}")==false)
+    throw new StrException("expecting \"}\"");
+  if(name!="") _defVec[name] = make_pair(string(type),&vec);
+  return true;
+}
+
 bool LoaderWrl::loadVecFloat(TokenizerFile&tkn,vector<float>& vec) {
   bool success = false;
   if(tkn.expecting("[")==false) throw new StrException("expecting \"[\"");
   float value;
-  while(success==false && tkn.get()) {
+  string_view v;
+  // most values are parsed in bulk by getFloats(); next() only sees
+  // the closing bracket, comments, and values crossing block ends
+  while(success==false) {
+    tkn.getFloats(vec);
+    if(tkn.next()==false) break;
+    v = tkn.view();
     if(tkn.equals("]")) {
       success = true; // done
-    } else if(sscanf(tkn.c_str(),"%f",&value)==1) {
+    } else if(NumberParser::parseFloat(v.data(),v.data()+v.size(),value)
+              !=v.data()) {
       vec.push_back(value);
     } else {
-      throw new StrException("expecting int value");
+      throw new StrException("expecting float value");
     }
   }
 
@@ -655,10 +703,15 @@ bool LoaderWrl::loadVecInt(TokenizerFile&tkn,vector<int>& vec) {
   bool success = false;
   if(tkn.expecting("[")==false) throw new StrException("expecting \"[\"");
   int value;
-  while(success==false && tkn.get()) {
+  string_view v;
+  while(success==false) {
+    tkn.getInts(vec);
+    if(tkn.next()==false) break;
+    v = tkn.view();
     if(tkn.equals("]")) {
       success = true; // done
-    } else if(sscanf(tkn.c_str(),"%d",&value)==1) {
+    } else if(NumberParser::parseInt(v.data(),v.data()+v.size(),value)
+              !=v.data()) {
       vec.push_back(value);
     } else {
       throw new StrException("expecting int value");
@@ -712,7 +765,11 @@ bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
 
     // create a TokenizerFile and start parsing
     TokenizerFile tkn(fp);
+    _def.clear();
+    _defVec.clear();
     loadSceneGraph(tkn,wrl);
+    _def.clear();
+    _defVec.clear();
 
     // will be done later
     // wrl.updateBBox();
@@ -726,6 +783,8 @@ bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
     if(fp!=(FILE*)0) fclose(fp);
     fprintf(stderr,"ERROR | %s\n",e->what());
     delete e;
+    _def.clear();
+    _defVec.clear();
     wrl.clear();
     wrl.setUrl("");
 
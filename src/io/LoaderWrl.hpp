@@ -35,6 +35,7 @@
 #ifndef _LOADER_WRL_HPP_
 #define _LOADER_WRL_HPP_
 
+#include <map>
 #include "Loader.hpp"
 #include "TokenizerFile.hpp"
 #include <wrl/Transform.hpp>
@@ -51,6 +52,12 @@ private:
 
   const static char* _ext;
 
+  // nodes defined with DEF in the file being loaded, and the arrays
+  // of the Coordinate, Normal, Color and TextureCoordinate nodes,
+  // with their types
+  map<string,Node*>                         _def;
+  map<string,pair<string,vector<float>*> >  _defVec;
+
 public:
 
   LoaderWrl()  {};
@@ -71,6 +78,11 @@ private:
   bool loadImageTexture(TokenizerFile& tkn, ImageTexture& imageTexture);
   bool loadIndexedFaceSet(TokenizerFile& tkn, IndexedFaceSet& ifs);
   bool loadIndexedLineSet(TokenizerFile& tkn, IndexedLineSet& ifs);
+  bool loadVecFloatNode(TokenizerFile& tkn, vector<float>& vec,
+                        const char* type, const char* field);
+  void define(const string& name, Node* node);
+  Node* loadUse(TokenizerFile& tkn);
+  Shape* loadShapeUse(TokenizerFile& tkn);
   bool loadVecFloat(TokenizerFile& tkn,vector<float>& vec);
   bool loadVecInt(TokenizerFile& tkn,vector<int>& vec);
   bool loadVecString(TokenizerFile& tkn,vector<string>& vec);
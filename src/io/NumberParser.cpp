@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:20 taubin>
+//------------------------------------------------------------------------
+//
+// NumberParser.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "NumberParser.hpp"
+
+// same separators as in the Tokenizer class
+static bool _isBlank[256] = {
+  false, false, false, false, false, false, false, false,
+  false, true,  true,  false, false, true,  false, false, // \t \n \015
+  false, false, false, false, false, false, false, false,
+  false, false, false, false, false, false, false, false,
+  true,  false, false, false, false, false, false, false, // ' '
+  false, false, false, false, true,  false, false, false, // ','
+};
+
+#define IS_BLANK(c) _isBlank[static_cast<unsigned char>(c)]
+
+// unlike strtof() and strtol(), from_chars() does not accept a
+// leading '+' sign
+static const char* _skipPlus(const char* first, const char* last) {
+  if(first+1<last && first[0]=='+' && first[1]!='+' && first[1]!='-')
+    first++;
+  return first;
+}
+
+// from_chars() leaves the value unchanged when it is out of range,
+// where strtof() and strtod() return +/-HUGE_VAL or +/-0; a long
+// double usually has enough range to tell which one, otherwise the
+// sign of the exponent does
+template <class T>
+static T _outOfRange(const char* first, const char* last) {
+  bool overflow;
+  long double ld;
+  if(from_chars(first,last,ld).ec==errc()) {
+    overflow = (fabsl(ld)>1.0L);
+  } else {
+    const char* e = first;
+    while(e<last && *e!='e' && *e!='E') e++;
+    overflow = (e+1>=last || e[1]!='-');
+  }
+  T value = (overflow)?numeric_limits<T>::infinity():T(0);
+  return (*first=='-')?-value:value;
+}
+
+template <class T>
+static const char* _parseReal(const char* first, const char* last, T& value) {
+  const char* p = _skipPlus(first,last);
+  T v;
+  from_chars_result r = from_chars(p,last,v);
+  if(r.ptr==p) return first;
+  if(r.ec==errc::result_out_of_range) {
+    v = _outOfRange<T>(p,r.ptr);
+  } else if(r.ptr+1<last && (*r.ptr=='x' || *r.ptr=='X') &&
+            (isxdigit(static_cast<unsigned char>(r.ptr[1])) ||
+             r.ptr[1]=='.') &&
+            r.ptr-p==((*p=='-')?2:1) && r.ptr[-1]=='0') {
+    // hexadecimal number, which from_chars() parses as 0
+    T h;
+    from_chars_result rh = from_chars(r.ptr+1,last,h,chars_format::hex);
+    if(rh.ec==errc()) {
+      v = (*p=='-')?-h:h;
+      r.ptr = rh.ptr;
+    }
+  }
+  value = v;
+  return r.ptr;
+}
+
+const char* NumberParser::parseFloat
+(const char* first, const char* last, float& f) {
+  return _parseReal(first,last,f);
+}
+
+const char* NumberParser::parseDouble
+(const char* first, const char* last, double& d) {
+  return _parseReal(first,last,d);
+}
+
+const char* NumberParser::parseLong
+(const char* first, const char* last, long& l) {
+  const char* p = _skipPlus(first,last);
+  long v;
+  from_chars_result r = from_chars(p,last,v);
+  if(r.ptr==p) return first;
+  if(r.ec==errc::result_out_of_range)
+    v = (*p=='-')?LONG_MIN:LONG_MAX;
+  l = v;
+  return r.ptr;
+}
+
+const char* NumberParser::parseULong
+(const char* first, const char* last, unsigned long& ul) {
+  const char* p = _skipPlus(first,last);
+  bool negative =
+    (p==first && p+1<last && p[0]=='-' && p[1]!='+' && p[1]!='-');
+  if(negative) p++;
+  unsigned long v;
+  from_chars_result r = from_chars(p,last,v);
+  if(r.ptr==p) return first;
+  if(r.ec==errc::result_out_of_range)
+    v = ULONG_MAX;
+  else if(negative)
+    v = 0UL-v;
+  ul = v;
+  return r.ptr;
+}
+
+// sscanf("%d") and atoi() truncate the value returned by strtol()
+const char* NumberParser::parseInt
+(const char* first, const char* last, int& i) {
+  long l;
+  const char* p = parseLong(first,last,l);
+  if(p!=first) i = static_cast<int>(l);
+  return p;
+}
+
+static inline const char*
+_parse(const char* first, const char* last, float& f) {
+  return NumberParser::parseFloat(first,last,f);
+}
+
+static inline const char*
+_parse(const char* first, const char* last, int& i) {
+  return NumberParser::parseInt(first,last,i);
+}
+
+template <class T>
+static const char* _parseArray
+(const char* first, const char* last, vector<T>& vec) {
+  T value;
+  const char* p = first;
+  for(;;) {
+    while(p<last && IS_BLANK(*p)) p++;
+    if(p==last) break;
+    const char* p0 = p;
+    p = _parse(p0,last,value);
+    if(p==p0) return p0;
+    while(p<last && !IS_BLANK(*p)) p++;
+    if(p==last) return p0;
+    vec.push_back(value);
+  }
+  return last;
+}
+
+const char* NumberParser::parseFloats
+(const char* first, const char* last, vector<float>& vec) {
+  return _parseArray(first,last,vec);
+}
+
+const char* NumberParser::parseInts
+(const char* first, const char* last, vector<int>& vec) {
+  return _parseArray(first,last,vec);
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:12 taubin>
+//------------------------------------------------------------------------
+//
+// NumberParser.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef NUMBER_PARSER_HPP
+#define NUMBER_PARSER_HPP
+
+#include <vector>
+
+using namespace std;
+
+// locale independent number parsing, based on std::from_chars(); the
+// values are the same as those returned by strtof(), strtod() and
+// strtol() in the "C" locale, which the loaders used to call through
+// sscanf(), atof() and atoi()
+
+namespace NumberParser {
+
+  // each of these functions parses the number found at the beginning
+  // of the characters [first,last), and returns a pointer to the
+  // first character following it; if no number is found, first is
+  // returned, and the value is not modified
+
+  const char* parseFloat (const char* first, const char* last, float&  f);
+  const char* parseDouble(const char* first, const char* last, double& d);
+  const char* parseInt   (const char* first, const char* last, int&    i);
+  const char* parseLong  (const char* first, const char* last, long&   l);
+  // as strtoul(), a leading '-' negates the value in unsigned
+  // arithmetic, and values out of range become ULONG_MAX
+  const char* parseULong (const char* first, const char* last, unsigned long& ul);
+
+  // parse a sequence of numbers separated by blank space or commas,
+  // as the Tokenizer class would split them, and append them to vec;
+  // as with sscanf(), the characters which follow a number within the
+  // same token are ignored; the parsing stops at the first token
+  // which is not a number, or which is not followed by blank space
+  // before last, since it may continue after last; returns a pointer
+  // to the first character of that token, or last
+
+  const char* parseFloats
+  (const char* first, const char* last, vector<float>& vec);
+  const char* parseInts
+  (const char* first, const char* last, vector<int>& vec);
+
+};
+
+#endif // NUMBER_PARSER_HPP
@@ -1020,13 +1020,16 @@ SaverPly::writeBinaryData
 
   int i,i0,i1,iF,nList,iV,iN,iC,j,k0,k1;
 
-  vector<float>& coord         = ifs.getCoord();
-  vector<int>&   coordIndex    = ifs.getCoordIndex();
-  vector<float>& normal        = ifs.getNormal();
-  vector<int>&   normalIndex   = ifs.getNormalIndex();
-  vector<float>& color         = ifs.getColor();
-  vector<int>&   colorIndex    = ifs.getColorIndex();
-  vector<float>& texCoord      = ifs.getTexCoord();
+  // const access, so that saving does not copy arrays shared with
+  // snapshots
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord         = cifs.getCoord();
+  const vector<int>&   coordIndex    = cifs.getCoordIndex();
+  const vector<float>& normal        = cifs.getNormal();
+  const vector<int>&   normalIndex   = cifs.getNormalIndex();
+  const vector<float>& color         = cifs.getColor();
+  const vector<int>&   colorIndex    = cifs.getColorIndex();
+  const vector<float>& texCoord      = cifs.getTexCoord();
   // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
 
   int nVertices = ifs.getNumberOfVertices();
@@ -1174,13 +1177,14 @@ SaverPly::writeAsciiData
   int i,i0,i1,iF,iV,iN,iC,j,k0,k1;
   uint nList;
 
-  vector<float>& coord         = ifs.getCoord();
-  vector<int>&   coordIndex    = ifs.getCoordIndex();
-  vector<float>& normal        = ifs.getNormal();
-  vector<int>&   normalIndex   = ifs.getNormalIndex();
-  vector<float>& color         = ifs.getColor();
-  vector<int>&   colorIndex    = ifs.getColorIndex();
-  vector<float>& texCoord      = ifs.getTexCoord();
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord         = cifs.getCoord();
+  const vector<int>&   coordIndex    = cifs.getCoordIndex();
+  const vector<float>& normal        = cifs.getNormal();
+  const vector<int>&   normalIndex   = cifs.getNormalIndex();
+  const vector<float>& color         = cifs.getColor();
+  const vector<int>&   colorIndex    = cifs.getColorIndex();
+  const vector<float>& texCoord      = cifs.getTexCoord();
   // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
 
   int nVertices = ifs.getNumberOfVertices();
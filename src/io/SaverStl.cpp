@@ -58,10 +58,11 @@ bool SaverStl::_saveAscii
 (FILE* fp, const char* solidname, IndexedFaceSet& ifs) const {
 
   int nF = ifs.getNumberOfFaces();
-  vector<float>& coords       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normals      = ifs.getNormal();
-  vector<int>&   normalIndex = ifs.getNormalIndex();
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coords       = cifs.getCoord();
+  const vector<int>&   coordIndex  = cifs.getCoordIndex();
+  const vector<float>& normals      = cifs.getNormal();
+  const vector<int>&   normalIndex = cifs.getNormalIndex();
   // already checked that ifs.getNormalPerVertex()==false
   bool           npf_indexed = (static_cast<int>(normalIndex.size())==nF);
 
@@ -103,10 +104,11 @@ bool SaverStl::_saveBinary
 (FILE* fp, const char* solidname, IndexedFaceSet& ifs) const {
 
   int nF = ifs.getNumberOfFaces();
-  vector<float>& coord       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
-  vector<int>&   normalIndex = ifs.getNormalIndex();
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord       = cifs.getCoord();
+  const vector<int>&   coordIndex  = cifs.getCoordIndex();
+  const vector<float>& normal      = cifs.getNormal();
+  const vector<int>&   normalIndex = cifs.getNormalIndex();
   // already checked that ifs.getNormalPerVertex()==false
   bool           npf_indexed = (static_cast<int>(normalIndex.size())==nF);
 
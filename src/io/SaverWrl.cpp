@@ -36,6 +36,34 @@
 
 const char* SaverWrl::_ext = "wrl";
 
+//////////////////////////////////////////////////////////////////////
+// a node with more than one parent is written once with DEF, and
+// referred to with USE afterwards; shared nodes without a name are
+// given one, so that they can be instanced
+bool SaverWrl::saveUse
+(FILE* fp, const char* str, Node* node, string& name) const {
+  name = node->getName();
+  map<const Node*,string>::const_iterator i = _saved.find(node);
+  if(i!=_saved.end()) {
+    map<string,const Node*>::const_iterator j = _defined.find(i->second);
+    // unless another node was defined with the same name afterwards
+    if(j!=_defined.end() && j->second==node) {
+      fprintf(fp,"%sUSE %s\n",str,i->second.c_str());
+      return true;
+    }
+  }
+  if(node->isShared()) {
+    if(name=="") {
+      char tmp[32];
+      sprintf(tmp,"_%d",(int)_saved.size()+1);
+      name = "_"+node->getType()+tmp;
+    }
+    _saved[node] = name;
+  }
+  if(name!="") _defined[name] = node;
+  return false;
+}
+
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveMaterial
 (FILE* fp, string indent, Material* material) const {
@@ -52,7 +80,8 @@ void SaverWrl::saveMaterial
   //   SFFloat transparency     0
   // }
 
-  const string& name = material->getName();
+  string name;
+  if(saveUse(fp,str,material,name)) return;
   if(name=="")
     fprintf(fp,"%sMaterial {\n",str);
   else
@@ -101,7 +130,8 @@ void SaverWrl::saveImageTexture
   //   SFBool repeatT TRUE
   // }
 
-  const string& name = imageTexture->getName();
+  string name;
+  if(saveUse(fp,str,imageTexture,name)) return;
   if(name=="")
     fprintf(fp,"%sImageTexture {\n",str);
   else
@@ -143,7 +173,8 @@ void SaverWrl::saveAppearance
 
   Node* node;
 
-  const string& name = appearance->getName();
+  string name;
+  if(saveUse(fp,str,appearance,name)) return;
   if(name=="")
     fprintf(fp,"%sAppearance {\n",str);
   else
@@ -191,28 +222,29 @@ void SaverWrl::saveIndexedFaceSet
   //   MFInt32 texCoordIndex     []        # [-1,)
   // }
 
-  const string& name = indexedFaceSet->getName();
+  string name;
+  if(saveUse(fp,str,indexedFaceSet,name)) return;
   if(name=="")
     fprintf(fp,"%sIndexedFaceSet {\n",str);
   else
     fprintf(fp,"%sDEF %s IndexedFaceSet {\n",str,name.c_str());
 
-  IndexedFaceSet& ifs = *indexedFaceSet;
+  const IndexedFaceSet& ifs = *indexedFaceSet;
 
-  bool&          ccw             = ifs.getCcw();
-  bool&          convex          = ifs.getConvex();
-  float&         creaseAngle     = ifs.getCreaseangle();
-  bool&          solid           = ifs.getSolid();
-  bool&          normalPerVertex = ifs.getNormalPerVertex();
-  bool&          colorPerVertex  = ifs.getColorPerVertex();
-  vector<float>& coord           = ifs.getCoord();
-  vector<int>&   coordIndex      = ifs.getCoordIndex();
-  vector<float>& normal          = ifs.getNormal();
-  vector<int>&   normalIndex     = ifs.getNormalIndex();
-  vector<float>& color           = ifs.getColor();
-  vector<int>&   colorIndex      = ifs.getColorIndex();
-  vector<float>& texCoord        = ifs.getTexCoord();
-  vector<int>&   texCoordIndex   = ifs.getTexCoordIndex();
+  bool                 ccw             = indexedFaceSet->getCcw();
+  bool                 convex          = indexedFaceSet->getConvex();
+  float                creaseAngle     = indexedFaceSet->getCreaseangle();
+  bool                 solid           = indexedFaceSet->getSolid();
+  bool                 normalPerVertex = indexedFaceSet->getNormalPerVertex();
+  bool                 colorPerVertex  = indexedFaceSet->getColorPerVertex();
+  const vector<float>& coord           = ifs.getCoord();
+  const vector<int>&   coordIndex      = ifs.getCoordIndex();
+  const vector<float>& normal          = ifs.getNormal();
+  const vector<int>&   normalIndex     = ifs.getNormalIndex();
+  const vector<float>& color           = ifs.getColor();
+  const vector<int>&   colorIndex      = ifs.getColorIndex();
+  const vector<float>& texCoord        = ifs.getTexCoord();
+  const vector<int>&   texCoordIndex   = ifs.getTexCoordIndex();
 
 
   // default ccw TRUE
@@ -378,19 +410,20 @@ void SaverWrl::saveIndexedLineSet
   //   SFBool  colorPerVertex    TRUE
   // }
 
-  const string& name = indexedLineSet->getName();
+  string name;
+  if(saveUse(fp,str,indexedLineSet,name)) return;
   if(name=="")
     fprintf(fp,"%sIndexedLineSet {\n",str);
   else
     fprintf(fp,"%sDEF %s IndexedLineSet {\n",str,name.c_str());
 
-  IndexedLineSet& ifs = *indexedLineSet;
+  const IndexedLineSet& ifs = *indexedLineSet;
 
-  vector<float>& coord           = ifs.getCoord();
-  vector<int>&   coordIndex      = ifs.getCoordIndex();
-  vector<float>& color           = ifs.getColor();
-  vector<int>&   colorIndex      = ifs.getColorIndex();
-  bool&          colorPerVertex  = ifs.getColorPerVertex();
+  const vector<float>& coord           = ifs.getCoord();
+  const vector<int>&   coordIndex      = ifs.getCoordIndex();
+  const vector<float>& color           = ifs.getColor();
+  const vector<int>&   colorIndex      = ifs.getColorIndex();
+  bool                 colorPerVertex  = indexedLineSet->getColorPerVertex();
 
   {
     int i;
@@ -626,6 +659,8 @@ bool SaverWrl::save(const char* filename, SceneGraph& wrl) const {
      FILE* fp = fopen(filename,"w");
     if(	fp!=(FILE*)0) {
       fprintf(fp,"#VRML V2.0 utf8\n");
+      _saved.clear();
+      _defined.clear();
       string indent="";
       int nChildren = wrl.getNumberOfChildren();
       for(int i=0;i<nChildren;i++) {
@@ -642,6 +677,8 @@ bool SaverWrl::save(const char* filename, SceneGraph& wrl) const {
         }
       }
       fclose(fp);
+      _saved.clear();
+      _defined.clear();
       success = true;
     }
   }
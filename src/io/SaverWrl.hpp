@@ -35,6 +35,7 @@
 #ifndef _SAVER_WRL_HPP_
 #define _SAVER_WRL_HPP_
 
+#include <map>
 #include "Saver.hpp"
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
@@ -51,6 +52,11 @@ private:
 
 const static char* _ext;
 
+  // shared nodes already written to the file, with their DEF names,
+  // and the last node defined with each name
+  mutable map<const Node*,string> _saved;
+  mutable map<string,const Node*> _defined;
+
 public:
 
   SaverWrl()  {};
@@ -61,6 +67,8 @@ public:
   
 private:
   
+  bool saveUse
+  (FILE* fp, const char* str, Node* node, string& name) const;
   void saveAppearance
   (FILE* fp, string indent, Appearance* appearance) const;
   void saveGroup
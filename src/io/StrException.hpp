@@ -60,7 +60,8 @@ class StrException : public exception {
 
 protected:
 
-  const string& _msg;
+  // a copy, since the message is usually a temporary string
+  const string _msg;
 
 public:
 
@@ -40,41 +40,98 @@
 // DAMAGE.
 
 #include <stdio.h>
+#include <string.h>
 #include "Tokenizer.hpp"
+#include "NumberParser.hpp"
 #include "StrException.hpp"
 
-Tokenizer::Tokenizer(): _skip(true) {
+// blank space characters which separate the tokens
+static bool _isBlank[256] = {
+  false, false, false, false, false, false, false, false,
+  false, true,  true,  false, false, true,  false, false, // \t \n \015
+  false, false, false, false, false, false, false, false,
+  false, false, false, false, false, false, false, false,
+  true,  false, false, false, false, false, false, false, // ' '
+  false, false, false, false, true,  false, false, false, // ','
+};
+
+#define IS_BLANK(c) _isBlank[static_cast<unsigned char>(c)]
+
+Tokenizer::Tokenizer():
+  _buf(""),
+  _pos(0),
+  _end(0),
+  _skip(true) {
 }
 
 void Tokenizer::setSkipComments(const bool value) {
   _skip = value;
 }
 
-bool Tokenizer::get() {
-  char c='\0';
-  do {
-    clear();
+bool Tokenizer::_nextBlock() {
+  return (_pos<_end || fill());
+}
+
+bool Tokenizer::next() {
+  for(;;) {
     // skip blank space
-    while((c=getc())!=EOF)
-      if(!(c==' ' || c=='\t' || c=='\n' || c==',' || c=='\015'))
-        { push_back(c); break; }
-    // collect token characters
-    while(((c=getc())!=EOF) &&
-          !(c==' ' || c=='\t' || c=='\n' || c==',' || c=='\015')) // c=="^M"
-      push_back(c);
-    // if comment, get the rest of the line, including blank spaces
-    if(size()>0 && (*this)[0]=='#') {
-      // last blank space character read is not in tkn yet
-      if(c!='\n')
-        push_back(c);
-      while((c=getc())!=EOF && c!='\n')
-        push_back(c);
+    for(;;) {
+      if(_nextBlock()==false) {
+        _view = string_view();
+        return false;
+      }
+      while(_pos<_end && IS_BLANK(_buf[_pos])) _pos++;
+      if(_pos<_end) break;
     }
-    // terminate the string
-    // push_back('\0');
-  } while(_skip && length()>0 && *(begin())=='#');
-  
-  return (length()>0)?true:false;
+    // collect token characters; the token is left in the block, unless
+    // it crosses the end of the block; the blank space character which
+    // ends the token is consumed
+    int    c  = EOF;
+    size_t p0 = _pos;
+    while(_pos<_end && !IS_BLANK(_buf[_pos])) _pos++;
+    if(_pos<_end) {
+      _view = string_view(_buf+p0,_pos-p0);
+      c = _buf[_pos++];
+    } else {
+      _spill.assign(_buf+p0,_pos-p0);
+      while(fill()) {
+        p0 = _pos;
+        while(_pos<_end && !IS_BLANK(_buf[_pos])) _pos++;
+        _spill.append(_buf+p0,_pos-p0);
+        if(_pos<_end) { c = _buf[_pos++]; break; }
+      }
+      _view = _spill;
+    }
+    if(_view[0]!='#') return true;
+    // comment; get the rest of the line, including blank spaces
+    if(_skip) {
+      if(c!='\n') nextline();
+      continue;
+    }
+    if(_view.data()!=_spill.data()) _spill.assign(_view);
+    if(c!='\n' && c!=EOF) {
+      _spill.push_back(static_cast<char>(c));
+      while(_nextBlock()) {
+        const char* nl =
+          static_cast<const char*>(memchr(_buf+_pos,'\n',_end-_pos));
+        size_t p1 = (nl!=nullptr)?static_cast<size_t>(nl-_buf):_end;
+        _spill.append(_buf+_pos,p1-_pos);
+        _pos = p1;
+        if(nl!=nullptr) { _pos++; break; }
+      }
+    }
+    _view = _spill;
+    return true;
+  }
+}
+
+bool Tokenizer::get() {
+  if(next()==false) {
+    clear();
+    return false;
+  }
+  assign(_view.data(),_view.size());
+  return true;
 }
 
 void Tokenizer::get(const string& errMsg) /* throw(StrException *) */ {
@@ -83,21 +140,33 @@ void Tokenizer::get(const string& errMsg) /* throw(StrException *) */ {
 
 bool Tokenizer::getline() {
   clear();
-  char c='\0';
-  while((c=getc())!=EOF && c!='\n') {
-    push_back(c);
+  while(_nextBlock()) {
+    const char* nl =
+      static_cast<const char*>(memchr(_buf+_pos,'\n',_end-_pos));
+    size_t p1 = (nl!=nullptr)?static_cast<size_t>(nl-_buf):_end;
+    append(_buf+_pos,p1-_pos);
+    _pos = p1;
+    if(nl!=nullptr) { _pos++; break; }
   }
+  _view = string_view(data(),size());
   return (length()>0)?true:false;
 }
 
 void Tokenizer::nextline() {
-  char c='\0';
-  while((c=getc())!=EOF && c!='\n');
+  while(_nextBlock()) {
+    const char* nl =
+      static_cast<const char*>(memchr(_buf+_pos,'\n',_end-_pos));
+    if(nl!=nullptr) {
+      _pos = static_cast<size_t>(nl-_buf)+1;
+      break;
+    }
+    _pos = _end;
+  }
 }
 
 bool Tokenizer::getBool(bool& b) {
   bool success = false;
-  if(get()) {
+  if(next()) {
     if(this->equals("t") || this->equals("true") ||
        this->equals("T") || this->equals("TRUE")) {
       b = true;
@@ -111,58 +180,100 @@ bool Tokenizer::getBool(bool& b) {
   return success;
 }
 
+static bool _parseInt(string_view tkn, int& i) {
+  const char* last = tkn.data()+tkn.size();
+  return (NumberParser::parseInt(tkn.data(),last,i)!=tkn.data());
+}
+
+// sscanf("%u") converts negative values as strtoul() does
+static bool _parseUInt(string_view tkn, unsigned int& ui) {
+  unsigned long ul;
+  const char* last = tkn.data()+tkn.size();
+  if(NumberParser::parseULong(tkn.data(),last,ul)==tkn.data()) return false;
+  ui = static_cast<unsigned int>(ul);
+  return true;
+}
+
+static bool _parseFloat(string_view tkn, float& f) {
+  const char* last = tkn.data()+tkn.size();
+  return (NumberParser::parseFloat(tkn.data(),last,f)!=tkn.data());
+}
+
 bool Tokenizer::getInt(int& i) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%d",&i)==1));
+    (next() && _parseInt(_view,i));
   return success;
 }
 
 bool Tokenizer::getUInt(unsigned int& ui) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%u",&ui)==1));
+    (next() && _parseUInt(_view,ui));
   return success;
 }
 
 bool Tokenizer::getFloat(float& f) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%f",&f)==1));
+    (next() && _parseFloat(_view,f));
   return success;
 }
 
 bool Tokenizer::getColor(Color& c) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%f",&(c.r))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(c.g))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(c.b))==1));
+    (next() && _parseFloat(_view,c.r)) &&
+    (next() && _parseFloat(_view,c.g)) &&
+    (next() && _parseFloat(_view,c.b));
   return success;
 }
 
 bool Tokenizer::getVec4f(Vec4f& v) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.x))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.y))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.z))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.w))==1));
+    (next() && _parseFloat(_view,v.x)) &&
+    (next() && _parseFloat(_view,v.y)) &&
+    (next() && _parseFloat(_view,v.z)) &&
+    (next() && _parseFloat(_view,v.w));
   return success;
 }
 
 bool Tokenizer::getVec3f(Vec3f& v) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.x))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.y))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.z))==1));
+    (next() && _parseFloat(_view,v.x)) &&
+    (next() && _parseFloat(_view,v.y)) &&
+    (next() && _parseFloat(_view,v.z));
   return success;
 }
 
 bool Tokenizer::getVec2f(Vec2f& v) {
   bool success =
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.x))==1)) &&
-    (get() && (sscanf(&((*this)[0]),"%f",&(v.y))==1));
+    (next() && _parseFloat(_view,v.x)) &&
+    (next() && _parseFloat(_view,v.y));
   return success;
 }
 
+// the numbers are parsed directly from the blocks; a token which
+// crosses the end of a block stops the parsing, and is left for next()
+
+size_t Tokenizer::getFloats(vector<float>& vec) {
+  size_t n0 = vec.size();
+  while(_nextBlock()) {
+    const char* p = NumberParser::parseFloats(_buf+_pos,_buf+_end,vec);
+    _pos = static_cast<size_t>(p-_buf);
+    if(_pos<_end) break;
+  }
+  return vec.size()-n0;
+}
+
+size_t Tokenizer::getInts(vector<int>& vec) {
+  size_t n0 = vec.size();
+  while(_nextBlock()) {
+    const char* p = NumberParser::parseInts(_buf+_pos,_buf+_end,vec);
+    _pos = static_cast<size_t>(p-_buf);
+    if(_pos<_end) break;
+  }
+  return vec.size()-n0;
+}
+
 bool Tokenizer::equals(const char* str) {
-  return ((*this)==str);
+  return (_view==str);
 }
 
 bool Tokenizer::expecting(const string& str) {
@@ -42,21 +42,47 @@
 #ifndef TOKENIZER_HPP
 #define TOKENIZER_HPP
 
+#include <string_view>
 #include <wrl/Node.hpp>
 
 // abstract class
 // use TokenizerFile or TokenizerString instead
+//
+// the input is scanned in blocks, provided by the derived classes
+// through fill(); get() copies each token into this string, while
+// next() only makes it available through view(), as a string_view
+// into the block, which is valid until the following call
+
 class Tokenizer : public string {
 
+protected:
+
+  // block of characters being scanned, from _buf[_pos] to _buf[_end];
+  // fill() replaces it with the next block, and returns false at the
+  // end of the input; the character _buf[_end] must be readable
+  const char* _buf;
+  size_t      _pos;
+  size_t      _end;
+
+  virtual bool fill() = 0;
+
 private:
 
-  bool _skip;
+  bool        _skip;
+  string_view _view;
+  // tokens which cross the end of a block, and comments, are
+  // assembled here
+  string      _spill;
 
-  virtual char getc() = 0;
+  bool _nextBlock();
 
 public:
 
   Tokenizer();
+  virtual ~Tokenizer() {}
+
+  bool next();
+  string_view view() const { return _view; }
 
   bool get();
   void get(const string& errMsg);
@@ -70,6 +96,14 @@ public:
   bool getVec3f(Vec3f& v);
   bool getVec4f(Vec4f& v);
   bool getVec2f(Vec2f& v);
+  // append numbers to vec, up to the first token which is not a
+  // number, which is left to be read by get() or next(); they may
+  // also leave a number which crosses the end of a block to next();
+  // return the number of values appended
+  size_t getFloats(vector<float>& vec);
+  size_t getInts(vector<int>& vec);
+  // equals() compares view(); getBool() and the number getters use
+  // next(), and so leave the string unchanged
   bool equals(const char* str);
   bool expecting(const string& str);
   bool expecting(const char* str);
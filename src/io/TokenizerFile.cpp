@@ -42,13 +42,26 @@
 #include <stdio.h>
 #include "TokenizerFile.hpp"
 
-TokenizerFile::TokenizerFile(FILE* fp):
+TokenizerFile::TokenizerFile(FILE* fp, const size_t blockSize):
   Tokenizer(),
-  _fp(fp) {
+  _fp(fp),
+  _block(blockSize+1,'\0') {
 }
 
-char TokenizerFile::getc() {
-  return static_cast<char>(std::getc(_fp)); // c library function
+bool TokenizerFile::fill() {
+  if(_fp==(FILE*)0) return false;
+  size_t n = fread(_block.data(),1,_block.size()-1,_fp);
+  _block[n] = '\0';
+  _buf = _block.data();
+  _pos = 0;
+  _end = n;
+  return (n>0);
+}
+
+void TokenizerFile::sync() {
+  if(_fp!=(FILE*)0 && _pos<_end)
+    fseek(_fp,-static_cast<long>(_end-_pos),SEEK_CUR);
+  _pos = _end;
 }
 
 // #define LINE_BUFFER_LENGTH 1024
@@ -42,22 +42,33 @@
 #ifndef TOKENIZER_FILE_HPP
 #define TOKENIZER_FILE_HPP
 
+#include <stdio.h>
+#include <vector>
 #include "Tokenizer.hpp"
 
 class TokenizerFile : public Tokenizer {
 
 protected:
 
-  FILE* _fp;
-  bool  _skip; // if(_skip) skip comments
+  FILE*        _fp;
+  bool         _skip; // if(_skip) skip comments
+  vector<char> _block;
 
 private:
 
-  virtual char getc();
+  virtual bool fill();
 
 public:
 
-  TokenizerFile(FILE* fp);
+  // the file is read in blocks of blockSize bytes
+  TokenizerFile(FILE* fp, const size_t blockSize=1<<16);
+
+  // moves the position of the file back to the first character not
+  // yet consumed, which is needed before reading the rest of the file
+  // directly, or calling ftell(); it is not called by the destructor,
+  // since the file is often closed before the TokenizerFile goes out
+  // of scope
+  void sync();
 
   // bool getline();
 
@@ -44,13 +44,21 @@
 
 TokenizerString::TokenizerString(const string& str):
   Tokenizer(),
-  _str(str), // save a copy of str
-  _pos(0) {
+  _str(str) { // save a copy of str
+  // the whole string is a single block
+  _buf = _str.c_str();
+  _pos = 0;
+  _end = _str.length();
 }
 
-char TokenizerString::getc() {
-  if(_pos<_str.length())
-    return _str[_pos++];
-  else
-    return EOF;
+TokenizerString::TokenizerString(const char* str, const size_t length):
+  Tokenizer(),
+  _str() {
+  _buf = str;
+  _pos = 0;
+  _end = length;
+}
+
+bool TokenizerString::fill() {
+  return false;
 }
@@ -49,13 +49,15 @@ class TokenizerString : public Tokenizer {
 private:
 
   const string  _str;
-  size_t        _pos;
 
-  virtual char getc();
+  virtual bool fill();
 
 public:
 
   TokenizerString(const string& str);
+  // does not copy the characters, which have to remain unchanged, and
+  // followed by at least one readable character, while in use
+  TokenizerString(const char* str, const size_t length);
 
 };
 
@@ -54,12 +54,16 @@ class Data {
 public:
   bool   _debug;
   bool   _binaryOutput;
+  int    _nThreads;
+  float  _weldTolerance;
   string _inFile;
   string _outFile;
 public:
   Data():
     _debug(false),
     _binaryOutput(false),
+    _nThreads(1),
+    _weldTolerance(-1.0f),
     _inFile(""),
     _outFile("")
   { }
@@ -68,6 +72,8 @@ public:
 void options(Data& D) {
   cout << "   -d|-debug               [" << tv(D._debug)          << "]" << endl;
   cout << "   -b|-binaryOutput        [" << tv(D._binaryOutput)   << "]" << endl;
+  cout << "   -j|-threads n           [" << D._nThreads             << "]" << endl;
+  cout << "   -w|-weld tolerance      [" << D._weldTolerance        << "]" << endl;
 }
 
 void usage(Data& D) {
@@ -97,6 +103,12 @@ int main(int argc, char **argv) {
       D._debug = !D._debug;
     } else if(string(argv[i])=="-b" || string(argv[i])=="-binaryOutput") {
       D._binaryOutput = !D._binaryOutput;
+    } else if(string(argv[i])=="-j" || string(argv[i])=="-threads") {
+      if(++i>=argc) error("expecting number of threads");
+      D._nThreads = atoi(argv[i]);
+    } else if(string(argv[i])=="-w" || string(argv[i])=="-weld") {
+      if(++i>=argc) error("expecting weld tolerance");
+      D._weldTolerance = static_cast<float>(atof(argv[i]));
     } else if(string(argv[i])[0]=='-') {
       error("unknown option");
     } else if(D._inFile=="") {
@@ -129,8 +141,11 @@ int main(int argc, char **argv) {
 
   // register input file loaders
   LoaderPly* plyLoader = new LoaderPly();
+  LoaderPly::setNumberOfThreads(D._nThreads);
   loaderFactory.registerLoader(plyLoader);
   LoaderStl* stlLoader = new LoaderStl();
+  LoaderStl::setWeldTolerance(D._weldTolerance);
+  LoaderStl::setNumberOfThreads(D._nThreads);
   loaderFactory.registerLoader(stlLoader);
   LoaderWrl* wrlLoader = new LoaderWrl();
   loaderFactory.registerLoader(wrlLoader);
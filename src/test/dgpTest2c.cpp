@@ -33,10 +33,12 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <iostream>
+#include <chrono>
 
 using namespace std;
 
 #include <wrl/SceneGraphTraversal.hpp>
+#include <wrl/SceneGraphProcessor.hpp>
 
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
@@ -57,6 +59,10 @@ public:
   bool   _debug;
   bool   _binaryOutput;
   bool   _removeProperties;
+  int    _nThreads;
+  bool   _triangleMesh;
+  bool   _spatialReorder;
+  bool   _bakeTransforms;
   string _inFile;
   string _outFile;
 public:
@@ -64,6 +70,10 @@ public:
     _debug(false),
     _binaryOutput(false),
     _removeProperties(false),
+    _nThreads(1),
+    _triangleMesh(false),
+    _spatialReorder(false),
+    _bakeTransforms(false),
     _inFile(""),
     _outFile("")
   { }
@@ -73,6 +83,10 @@ void options(Data& D) {
   cout << "   -d|-debug               [" << tv(D._debug)            << "]" << endl;
   cout << "   -b|-binaryOutput        [" << tv(D._binaryOutput)     << "]" << endl;
   cout << "   -r|-removeProperties    [" << tv(D._removeProperties) << "]" << endl;
+  cout << "   -j|-threads n           [" << D._nThreads             << "]" << endl;
+  cout << "  -tm|-triangleMesh        [" << tv(D._triangleMesh)     << "]" << endl;
+  cout << "  -sr|-spatialReorder      [" << tv(D._spatialReorder)   << "]" << endl;
+  cout << "  -bt|-bakeTransforms      [" << tv(D._bakeTransforms)   << "]" << endl;
 }
 
 void usage(Data& D) {
@@ -104,6 +118,15 @@ int main(int argc, char **argv) {
       D._binaryOutput = !D._binaryOutput;
     } else if(string(argv[i])=="-r" || string(argv[i])=="-removeProperties") {
       D._removeProperties = !D._removeProperties;
+    } else if(string(argv[i])=="-j" || string(argv[i])=="-threads") {
+      if(++i>=argc) error("expecting number of threads");
+      D._nThreads = atoi(argv[i]);
+    } else if(string(argv[i])=="-tm" || string(argv[i])=="-triangleMesh") {
+      D._triangleMesh = !D._triangleMesh;
+    } else if(string(argv[i])=="-sr" || string(argv[i])=="-spatialReorder") {
+      D._spatialReorder = !D._spatialReorder;
+    } else if(string(argv[i])=="-bt" || string(argv[i])=="-bakeTransforms") {
+      D._bakeTransforms = !D._bakeTransforms;
     } else if(string(argv[i])[0]=='-') {
       error("unknown option");
     } else if(D._inFile=="") {
@@ -244,11 +267,94 @@ int main(int argc, char **argv) {
   if(D._debug) cout << "  } processing" << endl;
   if(D._debug) cout << endl;
 
+  ////////////////////////////////////////////////////////////////////
+  // reorder vertices and faces along a space filling curve; the passes
+  // which access coord through coordIndex, building a PolygonMesh and
+  // accumulating face centroids into the vertices, are timed before
+  // and after reordering
+
+  if(D._spatialReorder) {
+
+    auto timeDownstream = [&](double& tMesh, double& tCoord) {
+      tMesh = tCoord = 0.0;
+      Node* node;
+      SceneGraphTraversal sgt(wrl);
+      while((node=sgt.next())!=(Node*)0) {
+        Shape* shape = dynamic_cast<Shape*>(node);
+        if(shape==(Shape*)0) continue;
+        IndexedFaceSet* ifs =
+          dynamic_cast<IndexedFaceSet*>(shape->getGeometry());
+        if(ifs==(IndexedFaceSet*)0) continue;
+        int nV = ifs->getNumberOfVertices();
+        const vector<float>& coord      = ifs->getCoord();
+        const vector<int>&   coordIndex = ifs->getCoordIndex();
+        auto t0 = chrono::steady_clock::now();
+        PolygonMesh pm(nV,coordIndex,D._nThreads);
+        pm.buildVertexStars(D._nThreads);
+        auto t1 = chrono::steady_clock::now();
+        vector<float> sum(coord.size(),0.0f);
+        for(int i0=0,i1=0;i1<(int)coordIndex.size();i1++) {
+          if(coordIndex[i1]>=0) continue;
+          float c[3] = {0.0f,0.0f,0.0f};
+          for(int i=i0;i<i1;i++)
+            for(int j=0;j<3;j++) c[j] += coord[3*coordIndex[i]+j];
+          for(int i=i0;i<i1;i++)
+            for(int j=0;j<3;j++) sum[3*coordIndex[i]+j] += c[j];
+          i0 = i1+1;
+        }
+        auto t2 = chrono::steady_clock::now();
+        tMesh  += chrono::duration<double,milli>(t1-t0).count();
+        tCoord += chrono::duration<double,milli>(t2-t1).count();
+      }
+    };
+
+    double tMeshBefore,tCoordBefore,tMeshAfter,tCoordAfter;
+    timeDownstream(tMeshBefore,tCoordBefore);
+    auto t0 = chrono::steady_clock::now();
+    SceneGraphProcessor processor(wrl);
+    processor.spatialReorder(D._nThreads);
+    auto t1 = chrono::steady_clock::now();
+    timeDownstream(tMeshAfter,tCoordAfter);
+
+    if(D._debug) {
+      cout << "  spatialReorder {" << endl;
+      cout << "    nThreads          = " << D._nThreads << endl;
+      cout << "    tReorder          = "
+           << chrono::duration<double,milli>(t1-t0).count() << " ms" << endl;
+      cout << "    tPolygonMesh      = " << tMeshBefore << " -> "
+           << tMeshAfter << " ms" << endl;
+      cout << "    tCoordAccumulate  = " << tCoordBefore << " -> "
+           << tCoordAfter << " ms" << endl;
+      cout << "  } spatialReorder" << endl;
+      cout << endl;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // apply the transforms to the geometry and flatten the scene graph
+
+  if(D._bakeTransforms) {
+    auto t0 = chrono::steady_clock::now();
+    SceneGraphProcessor processor(wrl);
+    processor.bakeTransforms(D._nThreads);
+    auto t1 = chrono::steady_clock::now();
+
+    if(D._debug) {
+      cout << "  bakeTransforms {" << endl;
+      cout << "    nThreads          = " << D._nThreads << endl;
+      cout << "    tBake             = "
+           << chrono::duration<double,milli>(t1-t0).count() << " ms" << endl;
+      cout << "    nChildren         = " << wrl.getNumberOfChildren() << endl;
+      cout << "  } bakeTransforms" << endl;
+      cout << endl;
+    }
+  }
+
   ////////////////////////////////////////////////////////////////////
   // test HalfEdges, PolygonMesh, and PolygonMeshTest
 
   if(D._debug) {
-    PolygonMeshTest(wrl,"  ");
+    PolygonMeshTest(wrl,"  ",cout,D._nThreads,D._triangleMesh);
     cout << endl;
   }
   
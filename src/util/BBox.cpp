@@ -42,6 +42,11 @@
 #include <cmath>
 #include "BBox.hpp"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=1)
+#define BBOX_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 BBox::~BBox() {
   if(_min   !=(float*)0) delete [] _min;
   if(_max   !=(float*)0) delete [] _max;
@@ -213,3 +218,49 @@ float BBox::getDiameter() const {
   }
   return (diam2>0.0f)?(float)sqrt(diam2):0.0f;
 }
+
+bool BBox::getMinMax
+(const vector<float>& v, float* min /*[3]*/, float* max /*[3]*/) {
+  size_t nV = v.size()/3;
+  if(nV==0) return false;
+  const float* p = v.data();
+  int j;
+  for(j=0;j<3;j++)
+    min[j] = max[j] = p[j];
+  size_t iV = 1;
+#ifdef BBOX_USE_SSE
+  // four points are twelve floats, loaded in three registers whose
+  // lanes hold the coordinates (x,y,z,x), (y,z,x,y), and (z,x,y,z)
+  if(nV>=5) {
+    const float* q = p+3;
+    __m128 minA = _mm_loadu_ps(q  ), maxA = minA;
+    __m128 minB = _mm_loadu_ps(q+4), maxB = minB;
+    __m128 minC = _mm_loadu_ps(q+8), maxC = minC;
+    for(iV=5;iV+4<=nV;iV+=4) {
+      q = p+3*iV;
+      __m128 a = _mm_loadu_ps(q  );
+      __m128 b = _mm_loadu_ps(q+4);
+      __m128 c = _mm_loadu_ps(q+8);
+      minA = _mm_min_ps(minA,a); maxA = _mm_max_ps(maxA,a);
+      minB = _mm_min_ps(minB,b); maxB = _mm_max_ps(maxB,b);
+      minC = _mm_min_ps(minC,c); maxC = _mm_max_ps(maxC,c);
+    }
+    float mn[12],mx[12];
+    _mm_storeu_ps(mn  ,minA); _mm_storeu_ps(mx  ,maxA);
+    _mm_storeu_ps(mn+4,minB); _mm_storeu_ps(mx+4,maxB);
+    _mm_storeu_ps(mn+8,minC); _mm_storeu_ps(mx+8,maxC);
+    for(int i=0;i<12;i++) {
+      if(mn[i]<min[i%3]) min[i%3] = mn[i];
+      if(mx[i]>max[i%3]) max[i%3] = mx[i];
+    }
+  }
+#endif
+  for(;iV<nV;iV++) {
+    for(j=0;j<3;j++) {
+      float x = p[3*iV+j];
+      if(x<min[j]) min[j] = x;
+      if(x>max[j]) max[j] = x;
+    }
+  }
+  return true;
+}
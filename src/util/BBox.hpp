@@ -74,6 +74,13 @@ public:
 
   void   setMin(const float* value /*[3]*/);
   void   setMax(const float* value /*[3]*/);
+
+  // computes the minimum and maximum of the coordinates of the 3D
+  // points stored in v, with three floats per point, using SSE
+  // min/max reductions when available; returns false if v has no
+  // points
+  static bool getMinMax
+  (const vector<float>& v, float* min /*[3]*/, float* max /*[3]*/);
 };
 
 #endif /* _BBOX_HPP_ */
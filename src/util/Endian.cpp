@@ -87,6 +87,27 @@ Endian::SingleValueBuffer& Endian::swap8
   return buff;
 }
 
+// the value size is a constant in the inner loop, so that the compiler
+// can turn it into byte swap instructions, and vectorize it
+template <size_t size>
+static void _swapArray(uchar* b, const size_t n) {
+  uchar tmp;
+  size_t i,j;
+  for(i=0;i<n;i++,b+=size) {
+    for(j=0;j<size/2;j++) {
+      tmp = b[j]; b[j] = b[size-1-j]; b[size-1-j] = tmp;
+    }
+  }
+}
+
+void Endian::swapArray(void* data, const size_t size, const size_t n) {
+  uchar* b = static_cast<uchar*>(data);
+  switch(size) {
+  case 2: _swapArray<2>(b,n); break;
+  case 4: _swapArray<4>(b,n); break;
+  case 8: _swapArray<8>(b,n); break;
+  }
+}
 
 //////////////////////////////////////////////////////////////////////
 // static
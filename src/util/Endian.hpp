@@ -42,6 +42,8 @@
 #ifndef ENDIAN_HPP
 #define ENDIAN_HPP
 
+#include <cstddef>
+
 typedef unsigned char  uchar;
 typedef unsigned short ushort;
 typedef unsigned int   uint;
@@ -85,6 +87,9 @@ namespace Endian {
 #define swapLong   swap8
 #define swapDouble swap8
 
+  // swaps the bytes of n consecutive values of size 2, 4 or 8 bytes
+  void swapArray(void* data, const size_t size, const size_t n);
+
   bool isLittleEndianSystem();
 
 };
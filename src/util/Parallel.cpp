@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// Parallel.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "Parallel.hpp"
+
+int Parallel::getNumberOfCores() {
+  unsigned n = std::thread::hardware_concurrency();
+  return (n>0)?static_cast<int>(n):1;
+}
+
+int Parallel::getMinRangeSize() {
+  return 1<<16;
+}
+
+int Parallel::getNumberOfRanges(const int nThreads, const int n) {
+  int nRanges = (nThreads<=0)?getNumberOfCores():nThreads;
+  int maxRanges = n/getMinRangeSize();
+  if(nRanges>maxRanges) nRanges = maxRanges;
+  return (nRanges<1)?1:nRanges;
+}
+
+int Parallel::getRangeStart(const int k, const int nRanges, const int n) {
+  return static_cast<int>((static_cast<long long>(n)*k)/nRanges);
+}
+
+void Parallel::forRanges(const int nThreads, const int n,
+                         const std::function<void(int,int,int)>& f) {
+  int nRanges = getNumberOfRanges(nThreads,n);
+  std::vector<std::thread> thread;
+  for(int k=1;k<nRanges;k++)
+    thread.push_back(std::thread(f,k,
+                                 getRangeStart(k  ,nRanges,n),
+                                 getRangeStart(k+1,nRanges,n)));
+  f(0,0,getRangeStart(1,nRanges,n));
+  for(auto& t : thread) t.join();
+}
+
+void Parallel::forTasks(const int nThreads, const int nTasks,
+                        const std::function<void(int)>& f) {
+  int nT = (nThreads<=0)?getNumberOfCores():nThreads;
+  if(nT>nTasks) nT = nTasks;
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for(int i;(i=next.fetch_add(1,std::memory_order_relaxed))<nTasks;)
+      f(i);
+  };
+  std::vector<std::thread> thread;
+  for(int k=1;k<nT;k++)
+    thread.push_back(std::thread(worker));
+  worker();
+  for(auto& t : thread) t.join();
+}
+
+// sorts the pairs (key[i],val[i]) by increasing value of key[i],
+// where all the keys are smaller than 2^nBits; LSD radix sort with 11
+// bit digits, so that the histograms fit in the L1 cache; the sort is
+// stable, and the passes in which all the keys share the same digit
+// are skipped; small inputs are sorted with std::sort instead; each
+// thread histograms and scatters its own contiguous range of the
+// input, so the result does not depend on the number of threads
+
+void Parallel::radixSort
+(std::vector<uint64_t>& key, std::vector<int>& val, const int nBits, const int nThreads) {
+  const int nDigitBits = 11;
+  const int nDigits    = 1<<nDigitBits;
+  const int digitMask  = nDigits-1;
+  int n = static_cast<int>(key.size());
+  if(n<2) return;
+  if(n<nDigits) {
+    // sorting the (key,val) pairs is equivalent to a stable sort when
+    // the values are distinct and increasing
+    std::vector<std::pair<uint64_t,int>> kv(n);
+    for(int i=0;i<n;i++) kv[i] = std::make_pair(key[i],val[i]);
+    std::sort(kv.begin(),kv.end());
+    for(int i=0;i<n;i++) { key[i] = kv[i].first; val[i] = kv[i].second; }
+    return;
+  }
+  int nR = getNumberOfRanges(nThreads,n);
+  std::vector<uint64_t> key1(n);
+  std::vector<int>      val1(n);
+  // count[k*nDigits+d] is the number of keys with digit d in range k
+  std::vector<int>      count(nR*nDigits);
+  int k,d,sum,c;
+  for(int shift=0;shift<nBits;shift+=nDigitBits) {
+    forRanges(nThreads,n,[&](int k, int i0, int i1) {
+        int* cnt = count.data()+k*nDigits;
+        std::fill(cnt,cnt+nDigits,0);
+        for(int i=i0;i<i1;i++)
+          cnt[(key[i]>>shift)&digitMask]++;
+      });
+    d = static_cast<int>((key[0]>>shift)&digitMask);
+    for(sum=k=0;k<nR;k++) sum += count[k*nDigits+d];
+    if(sum==n) continue;
+    // the keys with digit d from range k are stored after all the keys
+    // with smaller digits, and after those with digit d from ranges <k
+    for(sum=d=0;d<nDigits;d++)
+      for(k=0;k<nR;k++) {
+        c = count[k*nDigits+d]; count[k*nDigits+d] = sum; sum += c;
+      }
+    forRanges(nThreads,n,[&](int k, int i0, int i1) {
+        int* cnt = count.data()+k*nDigits;
+        for(int i=i0;i<i1;i++) {
+          int j = cnt[(key[i]>>shift)&digitMask]++;
+          key1[j] = key[i];
+          val1[j] = val[i];
+        }
+      });
+    key.swap(key1);
+    val.swap(val1);
+  }
+}
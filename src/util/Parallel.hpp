@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// Parallel.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+namespace Parallel {
+
+  // - a range of n elements {0,1,...,n-1} is split into nRanges
+  //   contiguous ranges of similar size, and each range is processed
+  //   by a different thread
+  // - ranges are never smaller than getMinRangeSize() elements, so
+  //   that small inputs are processed in the calling thread
+  // - nThreads<=0 selects getNumberOfCores() threads
+
+  // number of hardware threads, or 1 if it cannot be determined
+  int  getNumberOfCores();
+
+  int  getMinRangeSize();
+
+  // number of ranges used to split n elements among nThreads threads;
+  // always >=1
+  int  getNumberOfRanges(const int nThreads, const int n);
+
+  // the k-th range is [getRangeStart(k,..),getRangeStart(k+1,..)),
+  // for 0<=k<nRanges
+  int  getRangeStart(const int k, const int nRanges, const int n);
+
+  // calls f(k,i0,i1) once for each one of the getNumberOfRanges()
+  // ranges; ranges k>0 are processed in new threads, and range k=0 in
+  // the calling thread; returns after all the calls have finished;
+  // f should not throw exceptions
+  void forRanges(const int nThreads, const int n,
+                 const std::function<void(int,int,int)>& f);
+
+  // calls f(i) once for each task 0<=i<nTasks; the tasks are handed
+  // out dynamically, in increasing order of i, to nThreads threads
+  // (no more than nTasks), one of them the calling thread, so that
+  // listing the tasks in decreasing order of cost balances the load;
+  // returns after all the calls have finished; f should not throw
+  // exceptions
+  void forTasks(const int nThreads, const int nTasks,
+                const std::function<void(int)>& f);
+
+  // stable sort of the pairs (key[i],val[i]) by increasing key[i],
+  // where all the keys are smaller than 2^nBits; stability requires
+  // the values to be distinct and increasing on input, as when they
+  // are element indices; the result does not depend on nThreads
+  void radixSort(std::vector<uint64_t>& key, std::vector<int>& val,
+                 const int nBits, const int nThreads=1);
+
+};
+
+#endif // PARALLEL_HPP
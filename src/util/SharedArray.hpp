@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2026-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// SharedArray.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef SHARED_ARRAY_HPP
+#define SHARED_ARRAY_HPP
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// copy-on-write array: copies of a SharedArray share the same buffer,
+// so that copying is O(1), and the buffer is copied only when one of
+// the arrays which share it is about to be modified
+
+template <class T>
+class SharedArray {
+
+private:
+
+  shared_ptr<vector<T> > _buffer;
+
+public:
+
+  SharedArray():
+    _buffer(make_shared<vector<T> >()) {
+  }
+
+  // read only access; never copies the buffer
+  const vector<T>& get() const {
+    return *_buffer;
+  }
+
+  // write access; copies the buffer first if it is shared
+  vector<T>& edit() {
+    if(_buffer.use_count()>1)
+      _buffer = make_shared<vector<T> >(*_buffer);
+    return *_buffer;
+  }
+
+  // replaces the buffer with an empty one, rather than copying a
+  // shared buffer just to clear it
+  void clear() {
+    if(_buffer.use_count()>1)
+      _buffer = make_shared<vector<T> >();
+    else
+      _buffer->clear();
+  }
+
+  bool isShared() const {
+    return _buffer.use_count()>1;
+  }
+
+  size_t size() const {
+    return _buffer->size();
+  }
+
+  const T& operator[](const size_t i) const {
+    return (*_buffer)[i];
+  }
+};
+
+#endif // SHARED_ARRAY_HPP
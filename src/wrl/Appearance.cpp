@@ -41,8 +41,10 @@ Appearance::Appearance():
   /* _textureTransform;((Node*)0) */
 {}
 
-Appearance::~Appearance()
-{}
+Appearance::~Appearance() {
+  Node::unref(_material,this);
+  Node::unref(_texture,this);
+}
 
 
 Node* Appearance::getMaterial() {
@@ -58,13 +60,17 @@ Node* Appearance::getTexture() {
 // }
 
 void Appearance::setMaterial(Node* material) {
-  material->setParent(this);
+  if(material!=(Node*)0) material->ref(this);
+  Node::unref(_material,this);
   _material = material;
+  _notifyRoot();
 }
 
 void Appearance::setTexture(Node* texture) {
-  texture->setParent(this);
+  if(texture!=(Node*)0) texture->ref(this);
+  Node::unref(_texture,this);
   _texture = texture;
+  _notifyRoot();
 }
 
 // void Appearance::setTextureTransform(Node* textureTransform) {
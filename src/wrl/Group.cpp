@@ -42,7 +42,8 @@
   
 Group::Group():
 _bboxCenter(0.0f,0.0f,0.0f),
-_bboxSize(-1.0f,-1.0f,-1.0f) {
+_bboxSize(-1.0f,-1.0f,-1.0f),
+_childIndexDirty(false) {
 }
 
 Group::~Group() {
@@ -55,17 +56,42 @@ Group::~Group() {
 }
 
 vector<pNode>& Group::getChildren() {
+  _childIndexDirty = true;
+  _notifyRoot();
   return _children;
 }
 
 Node* Group::getChild(const string& name) const {
-  Node* node = (Node*)0;
-  for(int i=0;i<(int)_children.size();i++)
-    if(_children[i]->nameEquals(name)) {
-      node = _children[i];
-      break;
-    }
-  return node;
+  _updateChildIndex();
+  unordered_map<string,vector<pNode> >::const_iterator i =
+    _childIndex.find(name);
+  return (i!=_childIndex.end())?i->second.front():(Node*)0;
+}
+
+void Group::_updateChildIndex() const {
+  if(_childIndexDirty==false) return;
+  _childIndex.clear();
+  for(pNode child : _children)
+    _childIndex[child->getName()].push_back(child);
+  _childIndexDirty = false;
+}
+
+void Group::_childRenamed(Node* child, const string& oldName) {
+  if(_childIndexDirty) return;
+  unordered_map<string,vector<pNode> >::iterator i = _childIndex.find(oldName);
+  if(i==_childIndex.end()) return; // not a child
+  vector<pNode>& list = i->second;
+  vector<pNode>::iterator j = find(list.begin(),list.end(),child);
+  if(j==list.end()) return;
+  list.erase(j);
+  if(list.empty()) _childIndex.erase(i);
+  // a child sharing the new name with other children has to be
+  // inserted in the order of _children, which is left to a rebuild
+  vector<pNode>& newList = _childIndex[child->getName()];
+  if(newList.empty())
+    newList.push_back(child);
+  else
+    _childIndexDirty = true;
 }
 
 int Group::getNumberOfChildren() const {
@@ -98,6 +124,10 @@ float Group::getBBoxDiameter() {
 void Group::addChild(const pNode child) {
   child->setParent(this);
   _children.push_back(child);
+  if(_childIndexDirty==false)
+    _childIndex[child->getName()].push_back(child);
+  setBBoxDirty();
+  _notifyRoot();
 }
 
 void Group::removeChild(const pNode child) {
@@ -105,10 +135,48 @@ void Group::removeChild(const pNode child) {
   node = find(_children.begin(),_children.end(),child);
   if(node!=_children.end()) {
     _children.erase(node);
-    delete &(*node);
+    if(_childIndexDirty==false) {
+      // a child renamed behind the index's back is not found under its
+      // current name; the index is then stale, and rebuilt when needed
+      unordered_map<string,vector<pNode> >::iterator i =
+        _childIndex.find(child->getName());
+      vector<pNode>::iterator j;
+      if(i!=_childIndex.end() &&
+         (j=find(i->second.begin(),i->second.end(),child))!=i->second.end()) {
+        i->second.erase(j);
+        if(i->second.empty()) _childIndex.erase(i);
+      } else {
+        _childIndexDirty = true;
+      }
+    }
+    delete child;
+    setBBoxDirty();
+    _notifyRoot();
   }
 }
 
+int Group::removeChildren(const string& name, const bool deleteChildren) {
+  _updateChildIndex();
+  unordered_map<string,vector<pNode> >::iterator i = _childIndex.find(name);
+  if(i==_childIndex.end()) return 0;
+  int nRemoved = (int)(i->second.size());
+  _childIndex.erase(i);
+  // stable compaction of the remaining children
+  size_t j = 0;
+  for(size_t k=0;k<_children.size();k++) {
+    pNode child = _children[k];
+    if(child->nameEquals(name)) {
+      if(deleteChildren) delete child;
+    } else {
+      _children[j++] = child;
+    }
+  }
+  _children.resize(j);
+  setBBoxDirty();
+  _notifyRoot();
+  return nRemoved;
+}
+
 void Group::setBBoxCenter(Vec3f& value) {
   _bboxCenter = value;
 }
@@ -177,44 +245,45 @@ void Group::updateBBox(vector<float>& coord) {
   }
 }
 
+// the bounding box of the subtree is cached in each node, so that only
+// the nodes marked by setBBoxDirty(), and their ancestors, are
+// recomputed
 void Group::updateBBox() {
+  Vec3f min,max;
+  if(getBBox(min,max)) {
+    _bboxCenter.x = (max.x+min.x)/2.0f;
+    _bboxCenter.y = (max.y+min.y)/2.0f;
+    _bboxCenter.z = (max.z+min.z)/2.0f;
+    _bboxSize.x   = (max.x-min.x);
+    _bboxSize.y   = (max.y-min.y);
+    _bboxSize.z   = (max.z-min.z);
+  } else {
+    clearBBox();
+  }
+}
+
+bool Group::_computeBBox(Vec3f& min, Vec3f& max) {
+  // TODO Thu Nov 08 18:25:47 2012
+  // apply the transforms to the bounding boxes of their children
+  bool empty = true;
+  Vec3f minChild,maxChild;
   int nChildren = getNumberOfChildren();
   for(int i=0;i<nChildren;i++) {
-    Node* node = (*this)[i];
-    if(node->isTransform()) {
-      Transform* transform = (Transform*)node;
-      transform->updateBBox();
-      // get vertices of bounding box
-      vector<float> coord;
-      transform->appendBBoxCoord(coord);
-      // apply the transform to thoe vertices
-      // TODO Thu Nov 08 18:25:47 2012
-      // update this group bounding box
-      updateBBox(coord);
-    } else if(node->isGroup()) {
-      Group* group = (Group*)node;
-      group->updateBBox();
-      // get vertices of bounding box
-      vector<float> coord;
-      group->appendBBoxCoord(coord);
-      // update this group bounding box
-      updateBBox(coord);
-    } else if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        IndexedFaceSet* pIfs = (IndexedFaceSet*)node;
-        vector<float> &coord = pIfs->getCoord();    
-        // update this group bounding box
-        updateBBox(coord);
-      } else if(node!=(Node*)0 && node->isIndexedLineSet()) {
-        IndexedLineSet* pIls = (IndexedLineSet*)node;
-        vector<float> &coord = pIls->getCoord();    
-        // update this group bounding box
-        updateBBox(coord);
-      }
+    if(_children[i]->getBBox(minChild,maxChild)==false) continue;
+    if(empty) {
+      min = minChild;
+      max = maxChild;
+      empty = false;
+    } else {
+      if(minChild.x<min.x) min.x = minChild.x;
+      if(minChild.y<min.y) min.y = minChild.y;
+      if(minChild.z<min.z) min.z = minChild.z;
+      if(maxChild.x>max.x) max.x = maxChild.x;
+      if(maxChild.y>max.y) max.y = maxChild.y;
+      if(maxChild.z>max.z) max.z = maxChild.z;
     }
   }
+  return (empty==false);
 }
 
 void Group::printInfo(string indent) {
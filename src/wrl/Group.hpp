@@ -44,6 +44,7 @@
 // }
 
 #include <vector>
+#include <unordered_map>
 #include "Node.hpp"
 
 using namespace std;
@@ -56,17 +57,32 @@ protected:
   Vec3f         _bboxCenter;
   Vec3f         _bboxSize;
 
+  // children by name, in the order of _children; maintained by
+  // addChild(), removeChild(), removeChildren() and the setName() of
+  // the children, and rebuilt on demand after _children is accessed
+  // through getChildren()
+  mutable unordered_map<string,vector<pNode> > _childIndex;
+  mutable bool                                 _childIndexDirty;
+
 public:
   
   Group();
   virtual ~Group();
 
+  // the name index is rebuilt after the vector is modified through
+  // the returned reference
   vector<pNode>&        getChildren();
+  // first child with the given name, or null
   Node*                 getChild(const string& name) const;
   int                   getNumberOfChildren() const;
   pNode                 operator[](const int i);
   void                  addChild(pNode child);
   void                  removeChild(pNode child);
+  // removes all the children with the given name in a single pass,
+  // deleting them if deleteChildren is true; returns the number of
+  // children removed
+  int                   removeChildren(const string& name,
+                                       const bool deleteChildren=true);
 
   Vec3f&                getBBoxCenter();
   Vec3f&                getBBoxSize();
@@ -85,6 +101,14 @@ public:
   typedef void          (*Operator)(Group& group);
 
   virtual void    printInfo(string indent);
+
+protected:
+
+  // union of the cached boxes of the children
+  virtual bool          _computeBBox(Vec3f& min, Vec3f& max);
+
+  virtual void          _childRenamed(Node* child, const string& oldName);
+  void                  _updateChildIndex() const;
 };
 
 #endif /* _Group_h_ */
@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include "util/CastMacros.hpp"
+#include "util/BBox.hpp"
 #include "IndexedFaceSet.hpp"
 
 // VRML'97
@@ -65,7 +66,9 @@ IndexedFaceSet::IndexedFaceSet():
   _creaseAngle(0),
   _solid(true),
   _normalPerVertex(true),
-  _colorPerVertex(true)
+  _colorPerVertex(true),
+  _nFaces(-1),
+  _nFacesSize(0)
 {}
 
 void IndexedFaceSet::clear() {
@@ -83,6 +86,16 @@ void IndexedFaceSet::clear() {
   _colorIndex.clear();
   _texCoord.clear();
   _texCoordIndex.clear();
+  setBBoxDirty();
+  setFacesDirty();
+}
+
+bool IndexedFaceSet::_computeBBox(Vec3f& min, Vec3f& max) {
+  float mn[3],mx[3];
+  if(BBox::getMinMax(_coord.get(),mn,mx)==false) return false;
+  min = Vec3f(mn[0],mn[1],mn[2]);
+  max = Vec3f(mx[0],mx[1],mx[2]);
+  return true;
 }
 
 bool&          IndexedFaceSet::getCcw()              { return _ccw;                }
@@ -91,14 +104,50 @@ float&         IndexedFaceSet::getCreaseangle()      { return _creaseAngle;
 bool&          IndexedFaceSet::getSolid()            { return _solid;              }
 bool&          IndexedFaceSet::getNormalPerVertex()  { return _normalPerVertex;    }
 bool&          IndexedFaceSet::getColorPerVertex()   { return _colorPerVertex;     }
-vector<float>& IndexedFaceSet::getCoord()            { return _coord;              }
-vector<int>&   IndexedFaceSet::getCoordIndex()       { return _coordIndex;         }
-vector<float>& IndexedFaceSet::getNormal()           { return _normal;             }
-vector<int>&   IndexedFaceSet::getNormalIndex()      { return _normalIndex;        }
-vector<float>& IndexedFaceSet::getColor()            { return _color;              }
-vector<int>&   IndexedFaceSet::getColorIndex()       { return _colorIndex;         }
-vector<float>& IndexedFaceSet::getTexCoord()         { return _texCoord;           }
-vector<int>&   IndexedFaceSet::getTexCoordIndex()    { return _texCoordIndex;      }
+vector<float>& IndexedFaceSet::getCoord()            { return _coord.edit();         }
+vector<int>&   IndexedFaceSet::getCoordIndex()       { return _coordIndex.edit();    }
+vector<float>& IndexedFaceSet::getNormal()           { return _normal.edit();        }
+vector<int>&   IndexedFaceSet::getNormalIndex()      { return _normalIndex.edit();   }
+vector<float>& IndexedFaceSet::getColor()            { return _color.edit();         }
+vector<int>&   IndexedFaceSet::getColorIndex()       { return _colorIndex.edit();    }
+vector<float>& IndexedFaceSet::getTexCoord()         { return _texCoord.edit();      }
+vector<int>&   IndexedFaceSet::getTexCoordIndex()    { return _texCoordIndex.edit(); }
+
+void IndexedFaceSet::getSnapshot(Snapshot& snapshot) const {
+  snapshot.ccw             = _ccw;
+  snapshot.convex          = _convex;
+  snapshot.creaseAngle     = _creaseAngle;
+  snapshot.solid           = _solid;
+  snapshot.coord           = _coord;
+  snapshot.coordIndex      = _coordIndex;
+  snapshot.normalPerVertex = _normalPerVertex;
+  snapshot.normal          = _normal;
+  snapshot.normalIndex     = _normalIndex;
+  snapshot.colorPerVertex  = _colorPerVertex;
+  snapshot.color           = _color;
+  snapshot.colorIndex      = _colorIndex;
+  snapshot.texCoord        = _texCoord;
+  snapshot.texCoordIndex   = _texCoordIndex;
+}
+
+void IndexedFaceSet::setSnapshot(const Snapshot& snapshot) {
+  _ccw             = snapshot.ccw;
+  _convex          = snapshot.convex;
+  _creaseAngle     = snapshot.creaseAngle;
+  _solid           = snapshot.solid;
+  _coord           = snapshot.coord;
+  _coordIndex      = snapshot.coordIndex;
+  _normalPerVertex = snapshot.normalPerVertex;
+  _normal          = snapshot.normal;
+  _normalIndex     = snapshot.normalIndex;
+  _colorPerVertex  = snapshot.colorPerVertex;
+  _color           = snapshot.color;
+  _colorIndex      = snapshot.colorIndex;
+  _texCoord        = snapshot.texCoord;
+  _texCoordIndex   = snapshot.texCoordIndex;
+  setBBoxDirty();
+  setFacesDirty();
+}
 
 int IndexedFaceSet::getNumberOfCoord() {
   return static_cast<int>(_coord.size()/3);
@@ -137,11 +186,19 @@ bool IndexedFaceSet::isTriangleMesh() {
 }
 
 int IndexedFaceSet::getNumberOfFaces()   {
-  int nFaces = 0;
-  for(int i=0;i<(int)_coordIndex.size();i++)
-    if(_coordIndex[i]<0)
-      nFaces++;
-  return nFaces;
+  if(_nFaces<0 || _nFacesSize!=_coordIndex.size()) {
+    int nFaces = 0;
+    for(int i=0;i<(int)_coordIndex.size();i++)
+      if(_coordIndex[i]<0)
+        nFaces++;
+    _nFaces     = nFaces;
+    _nFacesSize = _coordIndex.size();
+  }
+  return _nFaces;
+}
+
+void IndexedFaceSet::setFacesDirty() {
+  _nFaces = -1;
 }
 
 int IndexedFaceSet::getNumberOfCorners() {
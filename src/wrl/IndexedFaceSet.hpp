@@ -59,6 +59,7 @@
 // }
 
 #include "Node.hpp"
+#include "util/SharedArray.hpp"
 #include <vector>
 
 using namespace std;
@@ -72,19 +73,26 @@ private:
   float          _creaseAngle;
   bool           _solid;
 
-  vector<float>  _coord;
-  vector<int>    _coordIndex;
+  // the arrays are copy-on-write; the non-const get methods copy an
+  // array shared with a Snapshot before returning it
+  SharedArray<float>  _coord;
+  SharedArray<int>    _coordIndex;
 
-  bool           _normalPerVertex;
-  vector<float>  _normal;
-  vector<int>    _normalIndex;
+  bool                _normalPerVertex;
+  SharedArray<float>  _normal;
+  SharedArray<int>    _normalIndex;
 
-  bool           _colorPerVertex;
-  vector<float>  _color;
-  vector<int>    _colorIndex;
+  bool                _colorPerVertex;
+  SharedArray<float>  _color;
+  SharedArray<int>    _colorIndex;
 
-  vector<float>  _texCoord;
-  vector<int>    _texCoordIndex;
+  SharedArray<float>  _texCoord;
+  SharedArray<int>    _texCoordIndex;
+
+  // number of faces, cached while coordIndex keeps _nFacesSize
+  // elements, or -1 if it has to be recounted
+  int            _nFaces;
+  size_t         _nFacesSize;
 
 public:
   
@@ -106,8 +114,46 @@ public:
   vector<float>&  getTexCoord();
   vector<int>&    getTexCoordIndex();
 
+  // read only access to the arrays, which never copies them
+  const vector<float>&  getCoord()         const { return _coord.get();         }
+  const vector<int>&    getCoordIndex()    const { return _coordIndex.get();    }
+  const vector<float>&  getNormal()        const { return _normal.get();        }
+  const vector<int>&    getNormalIndex()   const { return _normalIndex.get();   }
+  const vector<float>&  getColor()         const { return _color.get();         }
+  const vector<int>&    getColorIndex()    const { return _colorIndex.get();    }
+  const vector<float>&  getTexCoord()      const { return _texCoord.get();      }
+  const vector<int>&    getTexCoordIndex() const { return _texCoordIndex.get(); }
+  // the coord buffer itself, for other nodes to share it
+  const SharedArray<float>& getCoordArray() const { return _coord;            }
+
+  // values of all the fields; taking a Snapshot is O(1) in the size
+  // of the arrays, which are shared until either side modifies them
+  struct Snapshot {
+    bool                ccw;
+    bool                convex;
+    float               creaseAngle;
+    bool                solid;
+    SharedArray<float>  coord;
+    SharedArray<int>    coordIndex;
+    bool                normalPerVertex;
+    SharedArray<float>  normal;
+    SharedArray<int>    normalIndex;
+    bool                colorPerVertex;
+    SharedArray<float>  color;
+    SharedArray<int>    colorIndex;
+    SharedArray<float>  texCoord;
+    SharedArray<int>    texCoordIndex;
+  };
+
+  void            getSnapshot(Snapshot& snapshot) const;
+  void            setSnapshot(const Snapshot& snapshot);
+
   bool            isTriangleMesh();
+  // the number of faces is recounted only if the size of coordIndex
+  // changes, or after setFacesDirty() is called, which is needed only
+  // if coordIndex is modified in place without changing its size
   int             getNumberOfFaces();
+  void            setFacesDirty();
   int             getNumberOfCorners();
 
   int             getNumberOfCoord();
@@ -161,6 +207,10 @@ public:
   typedef void    (*Operator)(IndexedFaceSet& ifs);
 
   virtual void    printInfo(string indent);
+
+protected:
+
+  virtual bool    _computeBBox(Vec3f& min, Vec3f& max);
 };
 
 #endif /* _IndexedFaceSet_h_ */
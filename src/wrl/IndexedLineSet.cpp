@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include "IndexedLineSet.hpp"
+#include "util/BBox.hpp"
 
 // VRML'97
 //
@@ -57,13 +58,22 @@ void IndexedLineSet::clear() {
   _color.clear();
   _colorIndex.clear();
   _colorPerVertex  = true;
+  setBBoxDirty();
+}
+
+bool IndexedLineSet::_computeBBox(Vec3f& min, Vec3f& max) {
+  float mn[3],mx[3];
+  if(BBox::getMinMax(_coord.get(),mn,mx)==false) return false;
+  min = Vec3f(mn[0],mn[1],mn[2]);
+  max = Vec3f(mx[0],mx[1],mx[2]);
+  return true;
 }
 
 bool&          IndexedLineSet::getColorPerVertex()   { return _colorPerVertex;     }
-vector<float>& IndexedLineSet::getCoord()            { return _coord;              }
-vector<int>&   IndexedLineSet::getCoordIndex()       { return _coordIndex;         }
-vector<float>& IndexedLineSet::getColor()            { return _color;              }
-vector<int>&   IndexedLineSet::getColorIndex()       { return _colorIndex;         }
+vector<float>& IndexedLineSet::getCoord()            { return _coord.edit();       }
+vector<int>&   IndexedLineSet::getCoordIndex()       { return _coordIndex.edit();  }
+vector<float>& IndexedLineSet::getColor()            { return _color.edit();       }
+vector<int>&   IndexedLineSet::getColorIndex()       { return _colorIndex.edit();  }
 
 int            IndexedLineSet::getNumberOfCoord()    { return (int)(_coord.size()/3);    }
 int            IndexedLineSet::getNumberOfColor()    { return (int)(_color.size()/3);    }
@@ -80,6 +90,28 @@ void IndexedLineSet::setColorPerVertex(bool value) {
   _colorPerVertex = value;
 }
 
+void IndexedLineSet::setCoordArray(const SharedArray<float>& coord) {
+  _coord = coord;
+  setBBoxDirty();
+}
+
+void IndexedLineSet::getSnapshot(Snapshot& snapshot) const {
+  snapshot.coord          = _coord;
+  snapshot.coordIndex     = _coordIndex;
+  snapshot.color          = _color;
+  snapshot.colorIndex     = _colorIndex;
+  snapshot.colorPerVertex = _colorPerVertex;
+}
+
+void IndexedLineSet::setSnapshot(const Snapshot& snapshot) {
+  _coord          = snapshot.coord;
+  _coordIndex     = snapshot.coordIndex;
+  _color          = snapshot.color;
+  _colorIndex     = snapshot.colorIndex;
+  _colorPerVertex = snapshot.colorPerVertex;
+  setBBoxDirty();
+}
+
 void IndexedLineSet::printInfo(string indent) {
   std::cout << indent;
   if(_name!="") std::cout << "DEF " << _name << " ";
@@ -48,6 +48,7 @@
 // }
 
 #include "Node.hpp"
+#include "util/SharedArray.hpp"
 #include <vector>
 
 using namespace std;
@@ -56,11 +57,12 @@ class IndexedLineSet : public Node {
 
 private:
 
-  vector<float> _coord;
-  vector<int>   _coordIndex;
-  vector<float> _color;
-  vector<int>   _colorIndex;
-  bool          _colorPerVertex;
+  // copy-on-write arrays, as in IndexedFaceSet
+  SharedArray<float> _coord;
+  SharedArray<int>   _coordIndex;
+  SharedArray<float> _color;
+  SharedArray<int>   _colorIndex;
+  bool               _colorPerVertex;
 
 public:
   
@@ -73,6 +75,25 @@ public:
   vector<float>& getColor();
   vector<int>&   getColorIndex();
 
+  const vector<float>& getCoord()      const { return _coord.get();      }
+  const vector<int>&   getCoordIndex() const { return _coordIndex.get(); }
+  const vector<float>& getColor()      const { return _color.get();      }
+  const vector<int>&   getColorIndex() const { return _colorIndex.get(); }
+  // makes coord share the buffer of another array, without copying
+  // it, until either side is modified
+  void                 setCoordArray(const SharedArray<float>& coord);
+
+  struct Snapshot {
+    SharedArray<float> coord;
+    SharedArray<int>   coordIndex;
+    SharedArray<float> color;
+    SharedArray<int>   colorIndex;
+    bool               colorPerVertex;
+  };
+
+  void           getSnapshot(Snapshot& snapshot) const;
+  void           setSnapshot(const Snapshot& snapshot);
+
   int            getNumberOfPolylines();
 
   int            getNumberOfCoord();
@@ -86,6 +107,10 @@ public:
   typedef void    (*Operator)(IndexedLineSet& ifs);
 
   virtual void    printInfo(string indent);
+
+protected:
+
+  virtual bool    _computeBBox(Vec3f& min, Vec3f& max);
 };
 
 #endif /* _IndexedLineSet_h_ */
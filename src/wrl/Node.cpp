@@ -33,6 +33,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 #include "Node.hpp"
 
@@ -160,7 +161,12 @@ void Vec4f::normalize() {
 Node::Node():
   _name(""),
   _parent((Node*)0),
-  _show(true) {
+  _show(true),
+  _refCount(0),
+  _bboxDirty(true),
+  _bboxEmpty(true),
+  _bboxMin(),
+  _bboxMax() {
 }
 
 Node::~Node() {
@@ -171,7 +177,12 @@ const string& Node::getName() const {
 }
 
 void Node::setName(const string& name) {
+  if(name==_name) return;
+  string oldName = _name;
   _name = name;
+  if(_parent!=(Node*)0 && _parent!=this)
+    const_cast<Node*>(_parent)->_childRenamed(this,oldName);
+  _notifyRoot();
 }
 
 bool Node::nameEquals(const string& name) {
@@ -207,6 +218,93 @@ int Node::getDepth() const {
   return d;
 }
 
+void Node::ref(const Node* parent) {
+  // a null parent is a reference held from outside the scene graph
+  if(parent!=(const Node*)0) {
+    if(_refCount==0 || _parent==(const Node*)0)
+      _parent = parent;
+    else
+      _sharedParents.push_back(parent);
+  }
+  _refCount++;
+}
+
+void Node::unref(Node* node, const Node* parent) {
+  if(node==(Node*)0) return;
+  if(parent==(const Node*)0) {
+    // only the count changes
+  } else if(node->_parent==parent) {
+    if(node->_sharedParents.size()>0) {
+      node->_parent = node->_sharedParents.back();
+      node->_sharedParents.pop_back();
+    } else {
+      node->_parent = (const Node*)0;
+    }
+  } else {
+    vector<const Node*>& sp = node->_sharedParents;
+    vector<const Node*>::iterator i = find(sp.begin(),sp.end(),parent);
+    if(i!=sp.end()) sp.erase(i);
+  }
+  if((--node->_refCount)<=0) delete node;
+}
+
+int Node::getRefCount() const {
+  return _refCount;
+}
+
+bool Node::isShared() const {
+  return (_parent!=(const Node*)0 && _sharedParents.size()>0);
+}
+
+bool Node::getBBox(Vec3f& min, Vec3f& max) {
+  if(_bboxDirty) {
+    _bboxEmpty = (_computeBBox(_bboxMin,_bboxMax)==false);
+    _bboxDirty = false;
+  }
+  if(_bboxEmpty) return false;
+  min = _bboxMin;
+  max = _bboxMax;
+  return true;
+}
+
+void Node::setBBoxDirty() {
+  // the root of the scene graph is its own parent; a shared node marks
+  // the paths through all its parents
+  Node* node = this;
+  for(;;) {
+    node->_bboxDirty = true;
+    for(const Node* shared : node->_sharedParents)
+      const_cast<Node*>(shared)->setBBoxDirty();
+    Node* parent = const_cast<Node*>(node->_parent);
+    if(parent==(Node*)0 || parent==node) break;
+    node = parent;
+  }
+}
+
+bool Node::isBBoxDirty() const {
+  return _bboxDirty;
+}
+
+bool Node::_computeBBox(Vec3f& /*min*/, Vec3f& /*max*/) {
+  return false;
+}
+
+void Node::_subtreeChanged() {
+}
+
+void Node::_notifyRoot() {
+  Node* node = this;
+  for(;;) {
+    Node* parent = const_cast<Node*>(node->_parent);
+    if(parent==(Node*)0 || parent==node) break;
+    node = parent;
+  }
+  node->_subtreeChanged();
+}
+
+void Node::_childRenamed(Node* /*child*/, const string& /*oldName*/) {
+}
+
 bool    Node::isAppearance() const     { return  false; }
 bool    Node::isGroup() const          { return  false; }
 bool    Node::isImageTexture() const   { return  false; }
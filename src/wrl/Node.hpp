@@ -36,6 +36,7 @@
 #define _Node_h_
 
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -94,6 +95,33 @@ protected:
   const Node* _parent;
   bool        _show;
 
+  // number of references from the fields of Shape and Appearance
+  // nodes, and from outside the scene graph; a node instanced with
+  // DEF/USE is referred to by several parents, the first one in
+  // _parent, and the others in _sharedParents
+  int                 _refCount;
+  vector<const Node*> _sharedParents;
+
+  // cached bounding box of the geometry in the subtree rooted at this
+  // node, valid while _bboxDirty is false
+  bool        _bboxDirty;
+  bool        _bboxEmpty;
+  Vec3f       _bboxMin;
+  Vec3f       _bboxMax;
+
+  // computes the bounding box of the geometry in the subtree rooted at
+  // this node, using the cached boxes of its children; returns false
+  // if the subtree has no geometry
+  virtual bool    _computeBBox(Vec3f& min, Vec3f& max);
+
+  // called by _notifyRoot() on the root of the tree containing a node
+  // whose children, name, or Shape fields have been modified; changes
+  // which only invalidate bounding boxes are not notified
+  virtual void    _subtreeChanged();
+  void            _notifyRoot();
+  // called by setName() on the parent of the renamed node
+  virtual void    _childRenamed(Node* child, const string& oldName);
+
 public:
   
   Node();
@@ -108,6 +136,28 @@ public:
   void            setShow(const bool value);
   int             getDepth() const; 
 
+  // registers one more reference to this node from parent, which may
+  // be null for references held from outside the scene graph
+  void            ref(const Node* parent);
+  // releases the reference to node from parent, and deletes the node
+  // after its last reference is released
+  static void     unref(Node* node, const Node* parent);
+  int             getRefCount() const;
+  // true if the node has more than one parent in the scene graph
+  bool            isShared() const;
+
+  // returns in min and max the bounding box of the geometry in the
+  // subtree rooted at this node, or false if it has no geometry; the
+  // box is cached, and only recomputed after setBBoxDirty() is called
+  // on this node or on one of its descendants
+  bool            getBBox(Vec3f& min, Vec3f& max);
+  // marks the cached boxes of this node and of its ancestors as
+  // stale; it should be called after the geometry of the node, or the
+  // list of children of a group, is modified in place; it also
+  // invalidates the flattened representation of the scene graph
+  void            setBBoxDirty();
+  bool            isBBoxDirty() const;
+
   virtual bool    isAppearance() const;
   virtual bool    isGroup() const;
   virtual bool    isImageTexture() const;
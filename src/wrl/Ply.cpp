@@ -966,6 +966,9 @@ int Ply::Element::Property::getListFirst(const int i) {
   if(ui>=_first.size()) return -1;
   return _first[ui];
 }
+vector<int>& Ply::Element::Property::getFirst() {
+  return _first;
+}
 
 Ply::Element & Ply::Element::Property::element() {
   return _element;
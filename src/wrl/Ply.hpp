@@ -112,6 +112,8 @@ public:
       int              getPropertyTypeSize();
       void             pushBackList(const int nList);
       int              getListFirst(const int i);
+      // all the list offsets; getFirst()[i]==getListFirst(i)
+      vector<int>&     getFirst();
       Element&         element();
 
     private:
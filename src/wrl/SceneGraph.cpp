@@ -34,15 +34,20 @@
 
 #include <iostream>
 #include "SceneGraph.hpp"
-#include "SceneGraphTraversal.hpp"
+#include "SceneGraphFlat.hpp"
 #include "Shape.hpp"
 #include "Appearance.hpp"
   
-SceneGraph::SceneGraph() {
+SceneGraph::SceneGraph():
+  _version(0),
+  _flat((SceneGraphFlat*)0),
+  _nameIndexVersion(0),
+  _nameIndexValid(false) {
   _parent = this;
 }
 
 SceneGraph::~SceneGraph() {
+  if(_flat!=(SceneGraphFlat*)0) delete _flat;
 }
 
 void SceneGraph::clear() {
@@ -51,6 +56,10 @@ void SceneGraph::clear() {
     node = _children.back(); _children.pop_back();
     delete node;
   }
+  _childIndex.clear();
+  _childIndexDirty = false;
+  setBBoxDirty();
+  _subtreeChanged();
 }
 
 string& SceneGraph::getUrl() {
@@ -62,26 +71,51 @@ void SceneGraph::setUrl(const string& url) {
 }
 
 Node* SceneGraph::find(const string& name) {
-  Node* node = (Node*)0;
-  SceneGraphTraversal t(*this); t.start();
-  while((node=t.next())!=(Node*)0) {
-    if(node->nameEquals(name)) break;
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getAppearance();
-      if(node!=(Node*)0) {
-        if(node->nameEquals(name)) break;
-        Appearance* appearance = (Appearance*)node;
-        node = appearance->getMaterial();
-        if(node!=(Node*)0 && node->nameEquals(name)) break;
-        node = appearance->getTexture();
-        if(node!=(Node*)0 && node->nameEquals(name)) break;
-      }
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->nameEquals(name)) break;
+  if(_nameIndexValid==false || _nameIndexVersion!=_version)
+    _updateNameIndex();
+  unordered_map<string,Node*>::iterator i = _nameIndex.find(name);
+  return (i!=_nameIndex.end())?i->second:(Node*)0;
+}
+
+// the nodes are inserted in the order in which they used to be
+// searched, so that the first one found is kept for repeated names
+void SceneGraph::_updateNameIndex() {
+  _nameIndex.clear();
+  SceneGraphFlat& flat = getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    Node* node = flat.getNode(iNode);
+    _nameIndex.insert(make_pair(node->getName(),node));
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)node;
+    node = shape->getAppearance();
+    if(node!=(Node*)0) {
+      _nameIndex.insert(make_pair(node->getName(),node));
+      Appearance* appearance = (Appearance*)node;
+      node = appearance->getMaterial();
+      if(node!=(Node*)0) _nameIndex.insert(make_pair(node->getName(),node));
+      node = appearance->getTexture();
+      if(node!=(Node*)0) _nameIndex.insert(make_pair(node->getName(),node));
     }
+    node = shape->getGeometry();
+    if(node!=(Node*)0) _nameIndex.insert(make_pair(node->getName(),node));
   }
-  return node;
+  _nameIndexVersion = _version;
+  _nameIndexValid   = true;
+}
+
+unsigned SceneGraph::getVersion() const {
+  return _version;
+}
+
+SceneGraphFlat& SceneGraph::getFlat() {
+  if(_flat==(SceneGraphFlat*)0) _flat = new SceneGraphFlat(*this);
+  _flat->update();
+  return *_flat;
+}
+
+void SceneGraph::_subtreeChanged() {
+  _version++;
 }
 
 void SceneGraph::printInfo(string indent) {
@@ -46,11 +46,31 @@
 
 using namespace std;
 
+class SceneGraphFlat;
+
 class SceneGraph : public Group {
 
 private:
 
-  string _url;
+  string          _url;
+  // incremented every time the structure of the graph is modified,
+  // i.e. children added or removed, nodes renamed, or Shape fields
+  // replaced; edits of the geometry or of the Transform fields do not
+  // change it
+  unsigned        _version;
+  SceneGraphFlat* _flat;
+
+  // first node found with each name, valid while _version does not
+  // change
+  unordered_map<string,Node*> _nameIndex;
+  unsigned                    _nameIndexVersion;
+  bool                        _nameIndexValid;
+
+  void            _updateNameIndex();
+
+protected:
+
+  virtual void    _subtreeChanged();
 
 public:
   
@@ -64,6 +84,11 @@ public:
 
   Node*           find(const string& name);
 
+  unsigned        getVersion() const;
+  // returns the flattened representation of the graph, rebuilt if the
+  // graph has changed since the last call
+  SceneGraphFlat& getFlat();
+
   virtual bool    isSceneGraph() const { return         true; }
   virtual string  getType()      const { return "SceneGraph"; }
   typedef bool    (*Property)(SceneGraph& sceneGraph);
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:41:04 taubin>
+//------------------------------------------------------------------------
+//
+// SceneGraphFlat.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "SceneGraphFlat.hpp"
+
+SceneGraphFlat::SceneGraphFlat(SceneGraph& wrl):
+  _wrl(wrl),
+  _version(0),
+  _built(false) {
+}
+
+bool SceneGraphFlat::update() {
+  if(_built && _version==_wrl.getVersion()) return false;
+
+  _node.clear();
+  _parent.clear();
+  _depth.clear();
+  _kind.clear();
+  _transform.clear();
+  _end.clear();
+
+  // depth-first pre-order, with an explicit stack of (node,parent)
+  vector<pair<Node*,int> > stack;
+  int n = _wrl.getNumberOfChildren();
+  while((--n)>=0)
+    stack.push_back(make_pair(_wrl[n],-1));
+  while(stack.size()>0) {
+    Node* node   = stack.back().first;
+    int   parent = stack.back().second;
+    stack.pop_back();
+    int iNode = (int)_node.size();
+    Kind kind =
+      (node->isShape())?SHAPE:
+      (node->isTransform())?TRANSFORM:
+      (node->isGroup())?GROUP:OTHER;
+    _node.push_back(node);
+    _parent.push_back(parent);
+    _kind.push_back((char)kind);
+    if(parent<0) {
+      _depth.push_back(0);
+      _transform.push_back(-1);
+    } else {
+      _depth.push_back(_depth[parent]+1);
+      _transform.push_back
+        ((_kind[parent]==TRANSFORM)?parent:_transform[parent]);
+    }
+    if(kind==GROUP || kind==TRANSFORM) {
+      Group* group = (Group*)node;
+      n = group->getNumberOfChildren();
+      while((--n)>=0)
+        stack.push_back(make_pair((*group)[n],iNode));
+    }
+  }
+
+  // the descendants of a node follow it in pre-order, so the end of
+  // each subtree can be propagated upwards in a single reverse pass
+  int nNodes = (int)_node.size();
+  _end.resize(nNodes);
+  for(int iNode=0;iNode<nNodes;iNode++)
+    _end[iNode] = iNode+1;
+  for(int iNode=nNodes-1;iNode>=0;iNode--)
+    if(_parent[iNode]>=0 && _end[_parent[iNode]]<_end[iNode])
+      _end[_parent[iNode]] = _end[iNode];
+
+  _version = _wrl.getVersion();
+  _built   = true;
+  return true;
+}
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:41:04 taubin>
+//------------------------------------------------------------------------
+//
+// SceneGraphFlat.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// Linearized representation of a SceneGraph: the nodes below the root
+// are stored in depth-first pre-order in contiguous arrays, together
+// with the index of their parent, their depth, a kind tag, the index
+// of the enclosing Transform, and the end of their subtree. It is
+// owned by the SceneGraph, and rebuilt only when the graph changes.
+//
+// Use as follows
+//
+// class ShapeCounter : public SceneGraphVisitor {
+// public:
+//   int nShapes = 0;
+//   using SceneGraphVisitor::visit;
+//   void visit(Shape& shape, int iNode) { nShapes++; }
+// };
+//
+// ShapeCounter counter;
+// wrl.getFlat().traverse(counter);
+
+#ifndef _SceneGraphFlat_h_
+#define _SceneGraphFlat_h_
+
+#include <vector>
+#include "SceneGraph.hpp"
+#include "Transform.hpp"
+#include "Shape.hpp"
+
+using namespace std;
+
+// default handlers for SceneGraphFlat::traverse(); derived visitors
+// hide the ones they need, and bring the rest in with
+// 'using SceneGraphVisitor::visit;'; handlers for Group and Transform
+// nodes return false to skip the subtree
+class SceneGraphVisitor {
+public:
+  bool visit(Group&     /*group*/,     int /*iNode*/) { return true; }
+  bool visit(Transform& /*transform*/, int /*iNode*/) { return true; }
+  void visit(Shape&     /*shape*/,     int /*iNode*/) { }
+  void visit(Node&      /*node*/,      int /*iNode*/) { }
+};
+
+class SceneGraphFlat {
+
+public:
+
+  enum Kind {
+    OTHER     = 0,
+    GROUP     = 1,
+    TRANSFORM = 2,
+    SHAPE     = 3
+  };
+
+private:
+
+  SceneGraph&    _wrl;
+  unsigned       _version;
+  bool           _built;
+
+  vector<Node*>  _node;
+  vector<int>    _parent;    // -1 for the children of the root
+  vector<int>    _depth;     // same as Node::getDepth()
+  vector<char>   _kind;
+  vector<int>    _transform; // enclosing Transform, or -1
+  vector<int>    _end;       // one past the last node of the subtree
+
+public:
+
+  SceneGraphFlat(SceneGraph& wrl);
+
+  // rebuilds the arrays if the scene graph has changed since the last
+  // call; returns true if they were rebuilt
+  bool  update();
+  // version of the scene graph the arrays were last built from
+  unsigned getVersion() const { return _version; }
+
+  int   getNumberOfNodes() const { return (int)_node.size(); }
+  Node* getNode(const int iNode)        const { return _node[iNode];  }
+  int   getParent(const int iNode)      const { return _parent[iNode]; }
+  int   getDepth(const int iNode)       const { return _depth[iNode]; }
+  Kind  getKind(const int iNode)        const { return (Kind)_kind[iNode]; }
+  int   getTransform(const int iNode)   const { return _transform[iNode]; }
+  int   getSubtreeEnd(const int iNode)  const { return _end[iNode]; }
+
+  // visits the nodes in depth-first pre-order; the handler is chosen
+  // at compile time from the kind tag, without virtual calls or casts
+  // to be checked at run time
+  template<class Visitor> void traverse(Visitor& visitor);
+
+};
+
+template<class Visitor> void SceneGraphFlat::traverse(Visitor& visitor) {
+  int nNodes = getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;) {
+    Node* node = _node[iNode];
+    bool descend = true;
+    switch(_kind[iNode]) {
+    case SHAPE:
+      visitor.visit(*static_cast<Shape*>(node),iNode);
+      break;
+    case TRANSFORM:
+      descend = visitor.visit(*static_cast<Transform*>(node),iNode);
+      break;
+    case GROUP:
+      descend = visitor.visit(*static_cast<Group*>(node),iNode);
+      break;
+    default:
+      visitor.visit(*node,iNode);
+      break;
+    }
+    iNode = (descend)?iNode+1:_end[iNode];
+  }
+}
+
+#endif /* _SceneGraphFlat_h_ */
@@ -33,14 +33,26 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <math.h>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <unordered_set>
 #include "SceneGraphProcessor.hpp"
-#include "SceneGraphTraversal.hpp"
+#include "SceneGraphFlat.hpp"
 #include "Shape.hpp"
 #include "IndexedFaceSet.hpp"
 #include "IndexedLineSet.hpp"
 #include "Appearance.hpp"
 #include "Material.hpp"
+#include "Transform.hpp"
+#include "util/CastMacros.hpp"
+#include "util/Parallel.hpp"
+#include "core/HalfEdges.hpp"
+#include "core/ConcurrentPartition.hpp"
+#include "core/OccupancyGrid.hpp"
 
 SceneGraphProcessor::SceneGraphProcessor(SceneGraph& wrl):
   _wrl(wrl) {
@@ -49,40 +61,85 @@ SceneGraphProcessor::SceneGraphProcessor(SceneGraph& wrl):
 SceneGraphProcessor::~SceneGraphProcessor() {
 }
 
-void SceneGraphProcessor::normalClear() {
-  _applyToIndexedFaceSet(_normalClear);
+void SceneGraphProcessor::normalClear(const int nThreads) {
+  _applyToIndexedFaceSet([](IndexedFaceSet& ifs, int /*nThreadsIfs*/) {
+      _normalClear(ifs);
+    },nThreads);
 }
 
-void SceneGraphProcessor::normalInvert() {
-  _applyToIndexedFaceSet(_normalInvert);
+void SceneGraphProcessor::normalInvert(const int nThreads) {
+  _applyToIndexedFaceSet([](IndexedFaceSet& ifs, int /*nThreadsIfs*/) {
+      _normalInvert(ifs);
+    },nThreads);
 }
 
-void SceneGraphProcessor::computeNormalPerFace() {
-  _applyToIndexedFaceSet(_computeNormalPerFace);
+void SceneGraphProcessor::computeNormalPerFace(const int nThreads) {
+  _applyToIndexedFaceSet([](IndexedFaceSet& ifs, int /*nThreadsIfs*/) {
+      _computeNormalPerFace(ifs);
+    },nThreads);
 }
 
-void SceneGraphProcessor::computeNormalPerVertex() {
-  _applyToIndexedFaceSet(_computeNormalPerVertex);
+void SceneGraphProcessor::computeNormalPerVertex
+(const int nThreads, const NormalWeighting weighting) {
+  _applyToIndexedFaceSet([weighting](IndexedFaceSet& ifs, int nThreadsIfs) {
+      _computeNormalPerVertex(ifs,nThreadsIfs,weighting);
+    },nThreads);
 }
 
-void SceneGraphProcessor::computeNormalPerCorner() {
-  _applyToIndexedFaceSet(_computeNormalPerCorner);
+void SceneGraphProcessor::computeNormalPerCorner(const int nThreads) {
+  _applyToIndexedFaceSet([](IndexedFaceSet& ifs, int nThreadsIfs) {
+      _computeNormalPerCorner(ifs,nThreadsIfs);
+    },nThreads);
 }
 
-void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        IndexedFaceSet& ifs = *((IndexedFaceSet*)node);
-        o(ifs);
-      }
+void SceneGraphProcessor::_applyToIndexedFaceSet
+(const function<void(IndexedFaceSet&,int)>& o, const int nThreads) {
+  // 1) collect the IndexedFaceSets, each one only once
+  vector<IndexedFaceSet*> ifsList;
+  unordered_set<IndexedFaceSet*> ifsSet;
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedFaceSet()) {
+      IndexedFaceSet* ifs = (IndexedFaceSet*)(shape->getGeometry());
+      if(ifsSet.insert(ifs).second) ifsList.push_back(ifs);
     }
   }
+  int nIfs = static_cast<int>(ifsList.size());
+  int nT = (nThreads<=0)?Parallel::getNumberOfCores():nThreads;
+  if(nT==1 || nIfs<=1) {
+    for(IndexedFaceSet* ifs : ifsList) o(*ifs,nThreads);
+    return;
+  }
+
+  // 2) IndexedFaceSets with more corners than a fair share of the
+  //    total, and large enough to be split into several ranges, are
+  //    processed one after the other, each one using all the threads
+  // the const getter does not copy an array shared with a snapshot
+  auto nCorners = [](const IndexedFaceSet* ifs) {
+    return ifs->getCoordIndex().size();
+  };
+  size_t nCTotal = 0;
+  for(IndexedFaceSet* ifs : ifsList) nCTotal += nCorners(ifs);
+  vector<int> task;
+  for(int i=0;i<nIfs;i++) {
+    size_t nC = nCorners(ifsList[i]);
+    if(nC>nCTotal/nT && nC>=2*static_cast<size_t>(Parallel::getMinRangeSize()))
+      o(*ifsList[i],nThreads);
+    else
+      task.push_back(i);
+  }
+
+  // 3) the rest are processed as single threaded tasks, handed out
+  //    in decreasing order of number of corners
+  stable_sort(task.begin(),task.end(),[&](int i, int j) {
+      return nCorners(ifsList[i])>nCorners(ifsList[j]);
+    });
+  Parallel::forTasks(nT,static_cast<int>(task.size()),[&](int k) {
+      o(*ifsList[task[k]],1);
+    });
 }
 
 void SceneGraphProcessor::_normalClear(IndexedFaceSet& ifs) {
@@ -100,7 +157,7 @@ void SceneGraphProcessor::_normalInvert(IndexedFaceSet& ifs) {
 }
 
 void SceneGraphProcessor::_computeFaceNormal
-(vector<float>& coord, vector<int>& coordIndex,
+(const vector<float>& coord, const vector<int>& coordIndex,
  int i0, int i1, Vec3f& n, bool normalize) {
   int niF,iV,i;
   Vec3f p,pi,ni,v1,v2;
@@ -189,10 +246,13 @@ void SceneGraphProcessor::_computeFaceNormal
 
 void SceneGraphProcessor::_computeNormalPerFace(IndexedFaceSet& ifs) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_FACE) return;
-  vector<float>& coord       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
-  vector<int>&   normalIndex = ifs.getNormalIndex();
+  // coord and coordIndex are only read, and are not copied if they
+  // are shared with a snapshot
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord       = cifs.getCoord();
+  const vector<int>&   coordIndex  = cifs.getCoordIndex();
+  vector<float>&       normal      = ifs.getNormal();
+  vector<int>&         normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(false);
   normal.clear();
   normalIndex.clear();
@@ -209,133 +269,773 @@ void SceneGraphProcessor::_computeNormalPerFace(IndexedFaceSet& ifs) {
   }
 }
 
-void SceneGraphProcessor::_computeNormalPerVertex(IndexedFaceSet& ifs) {
+void SceneGraphProcessor::_computeNormalPerVertex
+(IndexedFaceSet& ifs, const int nThreads, const NormalWeighting weighting) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX) return;
-  vector<float>& coord       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
-  vector<int>&   normalIndex = ifs.getNormalIndex();
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord       = cifs.getCoord();
+  const vector<int>&   coordIndex  = cifs.getCoordIndex();
+  vector<float>&       normal      = ifs.getNormal();
+  vector<int>&         normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(true);
   normal.clear();
   normalIndex.clear();
-  Vec3f n;
-  int /*iF,*/ nV,i,i0,i1,iV;
-  float x0,x1,x2;
-  nV = (int)(coord.size()/3);
-  // initialize accumulators
-  normal.insert(normal.end(),coord.size(),0.0f);
-  // accumulate face normals
-  for(i0=i1=0;i1<(int)coordIndex.size();i1++) {
-    if(coordIndex[i1]<0) {
-      _computeFaceNormal(coord,coordIndex,i0,i1,n,false);
-      // accumulate
-      for(i=i0;i<i1;i++) {
-        iV = coordIndex[i];
-        x0 = normal[3*iV  ];
-        x1 = normal[3*iV+1];
-        x2 = normal[3*iV+2];
-        normal[3*iV  ] = x0+((float)(n[0]));
-        normal[3*iV+1] = x1+((float)(n[1]));
-        normal[3*iV+2] = x2+((float)(n[2]));
+  int nV = (int)(coord.size()/3);
+  vector<int> faceFirst;
+  int nF = _getFaceFirst(coordIndex,nV,faceFirst,nThreads);
+  if(nF<0) return;
+  // corners are numbered without the separators, so that corner h of
+  // face iF is at position h+iF of coordIndex
+  int nH = faceFirst[nF]-nF;
+  bool angle = (weighting==NW_ANGLE);
+
+  // 1) face normals, stored as three separate arrays; they are unit
+  //    length for angle weighting, with the corner angles stored in
+  //    the weight array
+  vector<float> nx(nF),ny(nF),nz(nF),weight;
+  if(angle) weight.resize(nH);
+  Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+      Vec3f n;
+      for(int iF=f0;iF<f1;iF++) {
+        int i0 = faceFirst[iF], i1 = faceFirst[iF+1]-1;
+        _computeFaceNormal(coord,coordIndex,i0,i1,n,angle);
+        nx[iF] = n[0]; ny[iF] = n[1]; nz[iF] = n[2];
+        if(!angle) continue;
+        for(int i=i0;i<i1;i++) {
+          const float* p  = &coord[3*coordIndex[i]];
+          const float* pP = &coord[3*coordIndex[(i>i0)?i-1:i1-1]];
+          const float* pN = &coord[3*coordIndex[(i+1<i1)?i+1:i0]];
+          float e1[3] = { pN[0]-p[0],pN[1]-p[1],pN[2]-p[2] };
+          float e2[3] = { pP[0]-p[0],pP[1]-p[1],pP[2]-p[2] };
+          float c0 = e1[1]*e2[2]-e1[2]*e2[1];
+          float c1 = e1[2]*e2[0]-e1[0]*e2[2];
+          float c2 = e1[0]*e2[1]-e1[1]*e2[0];
+          float d  = e1[0]*e2[0]+e1[1]*e2[1]+e1[2]*e2[2];
+          weight[i-iF] = atan2f(sqrtf(c0*c0+c1*c1+c2*c2),d);
+        }
       }
-      i0=i1+1; /* iF++; */
+    });
+
+  // 2) accumulate the face normals into the vertex normals; the
+  //    contributions to each vertex are added in increasing corner
+  //    order, both when scattering over the faces in a single range,
+  //    and when gathering over the vertex to corner lists built in
+  //    parallel, so that the result does not depend on nThreads
+  normal.assign(3*nV,0.0f);
+  auto accumulate = [&](float* n, const int h, const int iF) {
+    if(angle) {
+      n[0] += weight[h]*nx[iF]; n[1] += weight[h]*ny[iF]; n[2] += weight[h]*nz[iF];
+    } else {
+      n[0] += nx[iF]; n[1] += ny[iF]; n[2] += nz[iF];
     }
+  };
+  if(Parallel::getNumberOfRanges(nThreads,nH)<=1) {
+    for(int iF=0;iF<nF;iF++)
+      for(int i=faceFirst[iF];i<faceFirst[iF+1]-1;i++)
+        accumulate(&normal[3*coordIndex[i]],i-iF,iF);
+  } else {
+    int nBits = 1;
+    while(nBits<31 && (1<<nBits)<nV) nBits++;
+    vector<uint64_t> key(nH);
+    vector<int>      corner(nH),cornerFace(nH);
+    Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+        for(int iF=f0;iF<f1;iF++)
+          for(int i=faceFirst[iF];i<faceFirst[iF+1]-1;i++) {
+            key[i-iF] = static_cast<uint64_t>(coordIndex[i]);
+            corner[i-iF] = i-iF;
+            cornerFace[i-iF] = iF;
+          }
+      });
+    Parallel::radixSort(key,corner,nBits,nThreads);
+    Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+        for(int iV=v0;iV<v1;iV++) {
+          int j0 = static_cast<int>
+            (lower_bound(key.begin(),key.end(),static_cast<uint64_t>(iV))-key.begin());
+          for(int j=j0;j<nH && key[j]==static_cast<uint64_t>(iV);j++)
+            accumulate(&normal[3*iV],corner[j],cornerFace[corner[j]]);
+        }
+      });
   }
-  for(iV=0;iV<nV;iV++) {
-    n[0] = normal[3*iV  ];
-    n[1] = normal[3*iV+1];
-    n[2] = normal[3*iV+2];
-    float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-    if(nn>0.0f) {
-      nn = (float)sqrt(nn);
-      n[0] /= nn; n[1] /= nn; n[2] /= nn;
-    }
-    normal[3*iV  ] = n[0];
-    normal[3*iV+1] = n[1];
-    normal[3*iV+2] = n[2];
-  }
+
+  // 3) normalize
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++) {
+        float* n = &normal[3*iV];
+        float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
+        if(nn>0.0f) {
+          nn = (float)sqrt(nn);
+          n[0] /= nn; n[1] /= nn; n[2] /= nn;
+        }
+      }
+    });
 }
 
-void SceneGraphProcessor::_computeNormalPerCorner(IndexedFaceSet& ifs) {
+void SceneGraphProcessor::_computeNormalPerCorner
+(IndexedFaceSet& ifs, const int nThreads) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_CORNER) return;
 
-  vector<float>& coord       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
-  vector<int>&   normalIndex = ifs.getNormalIndex();
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord       = cifs.getCoord();
+  const vector<int>&   coordIndex  = cifs.getCoordIndex();
+  vector<float>&       normal      = ifs.getNormal();
+  vector<int>&         normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(true);
   normal.clear();
   normalIndex.clear();
 
-  Vec3f pP,p0,pN,vP,vN,n;
-  int iF,i,i0,i1,ip,in,nFC,iN,iVp/*,iV0,iVn*/;
-  for(iF=i0=i1=0;i1<(int)coordIndex.size();i1++) {
-    if(coordIndex[i1]<0) {
-      nFC = i1-i0; // number of face corners
-      // n << 0,0,0;
-      n[0]=n[1]=n[2]=0.0f;
-      if(nFC>=3) { // polygon
-        for(i=i0;i<i1;i++) {
-          if((ip=i-1)< i0) ip=i1-1;
-          if((in=i+1)==i1) in=i0  ;
-
-          iVp = coordIndex[ip];
-          // iV0 = coordIndex[i ];
-          // iVn = coordIndex[in];
-
-          // pP << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          pP[0] = coord[3*iVp  ]; pP[1] = coord[3*iVp+1]; pP[2] = coord[3*iVp+2];
-          // p0 << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          p0[0] = coord[3*iVp  ]; p0[1] = coord[3*iVp+1]; p0[2] = coord[3*iVp+2];
-          // pN << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          pN[0] = coord[3*iVp  ]; pN[1] = coord[3*iVp+1]; pN[2] = coord[3*iVp+2];
-          // vP = pP-p0;
-          vP[0] = pP[0]-p0[0]; vP[1] = pP[1]-p0[1]; vP[2] = pP[2]-p0[2];
-          // vN = pN-p0;
-          vN[0] = pN[0]-p0[0]; vN[1] = pN[1]-p0[1]; vN[2] = pN[2]-p0[2];
-
-          // n = vN.cross(vP);
-          n[0] = vN[1]*vP[2]-vN[2]*vP[1];
-          n[1] = vN[2]*vP[0]-vN[0]*vP[2];
-          n[2] = vN[0]*vP[1]-vN[1]*vP[0];
-
-          // n.normalize();
-          float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-          if(nn>0.0f) {
-            nn = (float)sqrt(nn);
-            n[0] /= nn; n[1] /= nn; n[2] /= nn;
-          }
+  int nV = (int)(coord.size()/3);
+  vector<int> faceFirst;
+  int nF = _getFaceFirst(coordIndex,nV,faceFirst,nThreads);
+  if(nF<=0) return;
+  // HalfEdges expects the last face to be terminated
+  vector<int> coordIndexTerminated;
+  if(coordIndex.back()>=0) {
+    coordIndexTerminated = coordIndex;
+    coordIndexTerminated.push_back(-1);
+  }
+  const vector<int>& cIndex =
+    (coordIndexTerminated.size()>0)?coordIndexTerminated:coordIndex;
+  int nC = (int)cIndex.size();
+
+  // 1) face normals, not normalized, so that they are accumulated
+  //    weighted by face area
+  vector<float> faceNormal(3*nF);
+  Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+      Vec3f n;
+      for(int iF=f0;iF<f1;iF++) {
+        _computeFaceNormal(coord,cIndex,faceFirst[iF],faceFirst[iF+1]-1,n,false);
+        faceNormal[3*iF  ] = n[0];
+        faceNormal[3*iF+1] = n[1];
+        faceNormal[3*iF+2] = n[2];
+      }
+    });
+
+  // 2) the two faces incident to a regular edge are smooth across the
+  //    edge if the angle between their normals is less than the crease
+  //    angle; in that case the two pairs of corners of the faces at
+  //    the ends of the edge are joined, taking into account the
+  //    relative orientation of the faces; the parts of the resulting
+  //    partition of the corners are the smoothing groups
+  HalfEdges halfEdges(nV,cIndex,nThreads);
+  float cosCrease = (float)cos(ifs.getCreaseangle());
+  auto isSmooth = [&](const int iF0, const int iF1) {
+    const float* n0 = &faceNormal[3*iF0];
+    const float* n1 = &faceNormal[3*iF1];
+    float d  = n0[0]*n1[0]+n0[1]*n1[1]+n0[2]*n1[2];
+    float l0 = n0[0]*n0[0]+n0[1]*n0[1]+n0[2]*n0[2];
+    float l1 = n1[0]*n1[0]+n1[1]*n1[1]+n1[2]*n1[2];
+    return d>cosCrease*(float)sqrt(l0*l1);
+  };
+  vector<int> pairs(4*static_cast<size_t>(nC),-1);
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int iC=i0;iC<i1;iC++) {
+        int iT = halfEdges.getTwin(iC);
+        if(iT<0 || !isSmooth(halfEdges.getFace(iC),halfEdges.getFace(iT)))
+          continue;
+        int iN = halfEdges.getNext(iC);
+        bool flipped = (halfEdges.getSrc(iT)==cIndex[iC]);
+        size_t j = 4*static_cast<size_t>(iC);
+        pairs[j  ] = iC; pairs[j+1] = flipped?iT:halfEdges.getNext(iT);
+        pairs[j+2] = iN; pairs[j+3] = flipped?halfEdges.getNext(iT):iT;
+      }
+    });
+  ConcurrentPartition partition(nC);
+  partition.joinAll(pairs,nThreads);
+  vector<int>().swap(pairs);
+
+  // 3) one normal per smoothing group; the face separators are
+  //    singletons of the partition, and face iF is preceded by iF
+  //    separators, so that the normal index of corner iC is its dense
+  //    part ID minus the face index of the smallest corner in its part
+  int nN = partition.compact(nThreads)-nF;
+  normalIndex.resize(coordIndex.size());
+  Parallel::forRanges(nThreads,(int)coordIndex.size(),[&](int /*k*/, int i0, int i1) {
+      for(int iC=i0;iC<i1;iC++)
+        normalIndex[iC] = (cIndex[iC]<0)?-1:
+          partition.getPart(iC)-halfEdges.getFace(partition.find(iC));
+    });
+  normal.assign(3*nN,0.0f);
+  for(int iF=0;iF<nF;iF++)
+    for(int iC=faceFirst[iF];iC<faceFirst[iF+1]-1;iC++) {
+      float* n = &normal[3*normalIndex[iC]];
+      n[0] += faceNormal[3*iF  ];
+      n[1] += faceNormal[3*iF+1];
+      n[2] += faceNormal[3*iF+2];
+    }
+  Parallel::forRanges(nThreads,nN,[&](int /*k*/, int j0, int j1) {
+      for(int j=j0;j<j1;j++) {
+        float* n = &normal[3*j];
+        float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
+        if(nn>0.0f) {
+          nn = (float)sqrt(nn);
+          n[0] /= nn; n[1] /= nn; n[2] /= nn;
+        }
+      }
+    });
+}
+
+void SceneGraphProcessor::spatialReorder(const int nThreads) {
+  _applyToIndexedFaceSet([](IndexedFaceSet& ifs, int nThreadsIfs) {
+      _spatialReorder(ifs,nThreadsIfs);
+    },nThreads);
+}
+
+int SceneGraphProcessor::_getFaceFirst
+(const vector<int>& coordIndex, const int nV,
+ vector<int>& faceFirst, const int nThreads) {
+  int nC = static_cast<int>(coordIndex.size());
+  faceFirst.assign(1,0);
+  if(nC==0) return 0;
+  // count the faces ending in each range of corners
+  int nR = Parallel::getNumberOfRanges(nThreads,nC);
+  vector<int>  nFacesRange(nR,0);
+  vector<char> badRange(nR,0);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      for(int i=i0;i<i1;i++)
+        if(coordIndex[i]>=nV || coordIndex[i]<-1) badRange[k] = 1;
+        else if(coordIndex[i]<0) nFacesRange[k]++;
+    });
+  int nF = 0;
+  for(int k=0;k<nR;k++) {
+    if(badRange[k]) return -1;
+    int n = nFacesRange[k]; nFacesRange[k] = nF; nF += n;
+  }
+  bool terminated = (coordIndex[nC-1]<0);
+  if(!terminated) nF++;
+  faceFirst.resize(nF+1);
+  faceFirst[nF] = nC+(terminated?0:1);
+  Parallel::forRanges(nThreads,nC,[&](int k, int i0, int i1) {
+      int iF = nFacesRange[k];
+      for(int i=i0;i<i1;i++)
+        if(coordIndex[i]<0) faceFirst[++iF] = i+1;
+    });
+  return nF;
+}
 
-          iN = (int)(normal.size()/3);
-          normal.push_back(n[0]);
-          normal.push_back(n[1]);
-          normal.push_back(n[2]);
-          normalIndex.push_back(iN);
+void SceneGraphProcessor::_getCoordBBox
+(const vector<float>& coord, const int nV,
+ float bMin[3], float bMax[3], const int nThreads) {
+  int nRV = Parallel::getNumberOfRanges(nThreads,nV);
+  vector<float> bboxRange(6*nRV);
+  Parallel::forRanges(nThreads,nV,[&](int k, int v0, int v1) {
+      float* b = &bboxRange[6*k];
+      for(int j=0;j<3;j++) b[j] = b[j+3] = coord[3*v0+j];
+      for(int iV=v0+1;iV<v1;iV++)
+        for(int j=0;j<3;j++) {
+          float x = coord[3*iV+j];
+          if(x<b[j  ]) b[j  ] = x;
+          if(x>b[j+3]) b[j+3] = x;
+        }
+    });
+  for(int j=0;j<3;j++) {
+    float x0 = bboxRange[j], x1 = bboxRange[j+3];
+    for(int k=1;k<nRV;k++) {
+      if(bboxRange[6*k+j  ]<x0) x0 = bboxRange[6*k+j  ];
+      if(bboxRange[6*k+j+3]>x1) x1 = bboxRange[6*k+j+3];
+    }
+    bMin[j] = x0;
+    bMax[j] = x1;
+  }
+}
 
+void SceneGraphProcessor::_spatialReorder(IndexedFaceSet& ifs, const int nThreads) {
+  // the other arrays are only taken through the non-const getters,
+  // which copy them if shared with a snapshot, where they are permuted
+  const IndexedFaceSet& cifs = ifs;
+  int nV = ifs.getNumberOfCoord();
+  int nC = static_cast<int>(cifs.getCoordIndex().size());
+  if(nV==0 || nC==0) return;
+
+  // 0) locate the faces; leave the IndexedFaceSet unchanged if
+  //    coordIndex contains indices out of range
+  vector<int> faceFirst;
+  int nF = _getFaceFirst(cifs.getCoordIndex(),nV,faceFirst,nThreads);
+  if(nF<0) return;
+  vector<float>& coord      = ifs.getCoord();
+  vector<int>&   coordIndex = ifs.getCoordIndex();
+
+  // 1) bounding box of the coordinates
+  float bMin[3],bMax[3],scale[3];
+  _getCoordBBox(coord,nV,bMin,bMax,nThreads);
+  for(int j=0;j<3;j++)
+    scale[j] = (bMax[j]>bMin[j])?1023.0f/(bMax[j]-bMin[j]):0.0f;
+
+  // 2) sort the vertices by the Morton code of their cell in a 1024^3
+  //    grid; ties keep the original order
+  vector<uint64_t> key(nV);
+  vector<int>      vertexOld(nV);
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++) {
+        int ix = static_cast<int>((coord[3*iV  ]-bMin[0])*scale[0]);
+        int iy = static_cast<int>((coord[3*iV+1]-bMin[1])*scale[1]);
+        int iz = static_cast<int>((coord[3*iV+2]-bMin[2])*scale[2]);
+        key[iV] = OccupancyGrid::getKey(ix,iy,iz);
+        vertexOld[iV] = iV;
+      }
+    });
+  Parallel::radixSort(key,vertexOld,30,nThreads);
+  vector<int> vertexNew(nV);
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++)
+        vertexNew[vertexOld[iV]] = iV;
+    });
+
+  // 3) permute the coordinates and the per-vertex properties
+  auto permuteVertices = [&](vector<float>& value, const int dim) {
+    vector<float> valueNew(value.size());
+    Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+        for(int iV=v0;iV<v1;iV++)
+          for(int j=0;j<dim;j++)
+            valueNew[dim*iV+j] = value[dim*vertexOld[iV]+j];
+      });
+    value.swap(valueNew);
+  };
+  permuteVertices(coord,3);
+  if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getNormal().size()==coord.size())
+    permuteVertices(ifs.getNormal(),3);
+  if(ifs.getColorBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getColor().size()==coord.size())
+    permuteVertices(ifs.getColor(),3);
+  if(ifs.getTexCoordBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getTexCoord().size()==UL(2*nV))
+    permuteVertices(ifs.getTexCoord(),2);
+
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int i=i0;i<i1;i++)
+        if(coordIndex[i]>=0) coordIndex[i] = vertexNew[coordIndex[i]];
+    });
+
+  // 4) sort the faces by their first vertex
+  int nBits = 1;
+  while(nBits<31 && (1<<nBits)<nV) nBits++;
+  key.resize(nF);
+  vector<int> faceOld(nF);
+  Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+      for(int iF=f0;iF<f1;iF++) {
+        int i = faceFirst[iF];
+        key[iF] = (i<nC && coordIndex[i]>=0)?static_cast<uint64_t>(coordIndex[i]):0;
+        faceOld[iF] = iF;
+      }
+    });
+  Parallel::radixSort(key,faceOld,nBits,nThreads);
+
+  // positions of the faces in the new order, by prefix sums of the
+  // face sizes over ranges of faces
+  int nRF = Parallel::getNumberOfRanges(nThreads,nF);
+  vector<int> sizeRange(nRF,0);
+  Parallel::forRanges(nThreads,nF,[&](int k, int f0, int f1) {
+      for(int iF=f0;iF<f1;iF++)
+        sizeRange[k] += faceFirst[faceOld[iF]+1]-faceFirst[faceOld[iF]];
+    });
+  for(int k=0,n=0;k<nRF;k++) {
+    int m = sizeRange[k]; sizeRange[k] = n; n += m;
+  }
+  vector<int> faceFirstNew(nF+1);
+  faceFirstNew[nF] = faceFirst[nF];
+  Parallel::forRanges(nThreads,nF,[&](int k, int f0, int f1) {
+      for(int iF=f0,n=sizeRange[k];iF<f1;iF++) {
+        faceFirstNew[iF] = n;
+        n += faceFirst[faceOld[iF]+1]-faceFirst[faceOld[iF]];
+      }
+    });
+
+  // 5) permute the arrays with one entry per corner, and with one
+  //    entry per face
+  auto permuteCorners = [&](vector<int>& index) {
+    vector<int> indexNew(faceFirst[nF]);
+    Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+        for(int iF=f0;iF<f1;iF++) {
+          int i0 = faceFirst[faceOld[iF]];
+          int n  = faceFirst[faceOld[iF]+1]-i0-1;
+          int j0 = faceFirstNew[iF];
+          for(int j=0;j<n;j++) indexNew[j0+j] = index[i0+j];
+          indexNew[j0+n] = -1;
         }
-        normalIndex.push_back(-1);
-
-      } else /* if(nFC<3) */{ // face with less than 3 vertices
-        // throw exception ?
-        // n << 0,0,0;
-        n[0]=n[1]=n[2]=0.0f;
-        for(i=i0;i<i1;i++) {
-          iN = (int)(normal.size()/3);
-          normal.push_back(n[0]);
-          normal.push_back(n[1]);
-          normal.push_back(n[2]);
-          normalIndex.push_back(iN);
+      });
+    index.swap(indexNew);
+  };
+  auto permuteFaces = [&](vector<float>& value) {
+    vector<float> valueNew(value.size());
+    Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+        for(int iF=f0;iF<f1;iF++)
+          for(int j=0;j<3;j++)
+            valueNew[3*iF+j] = value[3*faceOld[iF]+j];
+      });
+    value.swap(valueNew);
+  };
+  auto permuteFaceIndex = [&](vector<int>& index) {
+    vector<int> indexNew(nF);
+    Parallel::forRanges(nThreads,nF,[&](int /*k*/, int f0, int f1) {
+        for(int iF=f0;iF<f1;iF++) indexNew[iF] = index[faceOld[iF]];
+      });
+    index.swap(indexNew);
+  };
+  // editValue() and editIndex() return the arrays through the
+  // non-const getters, and are only called for the array permuted
+  auto permuteProperty = [&](const vector<float>& value,
+                             const vector<int>& index,
+                             const bool perVertex,
+                             auto editValue, auto editIndex) {
+    if(value.size()==0) return;
+    if(index.size()==UL(nC)) {
+      permuteCorners(editIndex());
+    } else if(!perVertex) {
+      if(index.size()==UL(nF))
+        permuteFaceIndex(editIndex());
+      else if(index.size()==0 && value.size()==UL(3*nF))
+        permuteFaces(editValue());
+    }
+  };
+  permuteProperty(cifs.getNormal(),cifs.getNormalIndex(),ifs.getNormalPerVertex(),
+                  [&]() -> vector<float>& { return ifs.getNormal();      },
+                  [&]() -> vector<int>&   { return ifs.getNormalIndex(); });
+  permuteProperty(cifs.getColor(),cifs.getColorIndex(),ifs.getColorPerVertex(),
+                  [&]() -> vector<float>& { return ifs.getColor();       },
+                  [&]() -> vector<int>&   { return ifs.getColorIndex();  });
+  if(cifs.getTexCoordIndex().size()==UL(nC))
+    permuteCorners(ifs.getTexCoordIndex());
+  permuteCorners(coordIndex);
+  ifs.setBBoxDirty();
+}
+
+void SceneGraphProcessor::weldVertices(const float tolerance, const int nThreads) {
+  _applyToIndexedFaceSet([tolerance](IndexedFaceSet& ifs, int nThreadsIfs) {
+      _weldVertices(ifs,tolerance,nThreadsIfs);
+    },nThreads);
+}
+
+void SceneGraphProcessor::_weldVertices
+(IndexedFaceSet& ifs, const float tolerance, const int nThreads) {
+  // nothing is taken through the non-const getters, which copy the
+  // arrays shared with a snapshot, until some vertices are merged
+  const IndexedFaceSet& cifs = ifs;
+  const vector<float>& coord      = cifs.getCoord();
+  const vector<int>&   coordIndex = cifs.getCoordIndex();
+  int nV = ifs.getNumberOfCoord();
+  if(nV<2) return;
+
+  // 0) leave the IndexedFaceSet unchanged if coordIndex contains
+  //    indices out of range
+  vector<int> faceFirst;
+  if(_getFaceFirst(coordIndex,nV,faceFirst,nThreads)<0) return;
+
+  // 1) vertices are merged if their fine keys, three 32-bit words per
+  //    vertex, are equal; the fine key is made of the bits of the
+  //    coordinates, or of the indices of the grid cell if tolerance>0;
+  //    the vertices are sorted by a coarse key of 21 bits per axis,
+  //    which is the same for equal fine keys
+  const bool     exact   = !(tolerance>0.0f);
+  const uint32_t cellMax = (1u<<21)-1;
+  float bMin[3],bMax[3];
+  _getCoordBBox(coord,nV,bMin,bMax,nThreads);
+  double scale[3];
+  int    shift = 0;
+  if(exact) {
+    for(int j=0;j<3;j++)
+      scale[j] = (bMax[j]>bMin[j])?cellMax/(static_cast<double>(bMax[j])-bMin[j]):0.0;
+  } else {
+    uint32_t qMax = 0;
+    for(int j=0;j<3;j++) {
+      double q = (static_cast<double>(bMax[j])-bMin[j])/tolerance;
+      if(q>4294967295.0) q = 4294967295.0;
+      if(q>qMax) qMax = static_cast<uint32_t>(q);
+    }
+    while((qMax>>shift)>cellMax) shift++;
+  }
+  // truncation of t>=0 clamped to tMax; NaN maps to 0
+  auto quantize = [](const double t, const double tMax) -> uint32_t {
+    return (t>=0.0)?static_cast<uint32_t>((t<tMax)?t:tMax):0u;
+  };
+  vector<uint32_t> fine(3*nV);
+  vector<uint64_t> key(nV);
+  vector<int>      vertexOld(nV);
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      uint32_t c[3];
+      for(int iV=v0;iV<v1;iV++) {
+        for(int j=0;j<3;j++) {
+          float x = coord[3*iV+j];
+          if(exact) {
+            memcpy(&fine[3*iV+j],&x,4);
+            c[j] = quantize((static_cast<double>(x)-bMin[j])*scale[j],cellMax);
+          } else {
+            fine[3*iV+j] =
+              quantize((static_cast<double>(x)-bMin[j])/tolerance,4294967295.0);
+            c[j] = fine[3*iV+j]>>shift;
+          }
         }
-        normalIndex.push_back(-1);
+        key[iV] = (static_cast<uint64_t>(c[0])<<42)|
+                  (static_cast<uint64_t>(c[1])<<21)|c[2];
+        vertexOld[iV] = iV;
       }
+    });
+  Parallel::radixSort(key,vertexOld,63,nThreads);
+
+  // 2) the vertices of each run of equal coarse keys are in increasing
+  //    order; the first vertex with each fine key represents the others;
+  //    each run is processed by the range where it starts
+  vector<int> vertexRep(nV);
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int i0, int i1) {
+      auto fineLess = [&](const int a, const int b) {
+        for(int j=0;j<3;j++)
+          if(fine[3*a+j]!=fine[3*b+j]) return fine[3*a+j]<fine[3*b+j];
+        return a<b;
+      };
+      vector<int> run;
+      int i = i0;
+      while(i>0 && i<i1 && key[i]==key[i-1]) i++;
+      while(i<i1) {
+        int i2 = i+1;
+        while(i2<nV && key[i2]==key[i]) i2++;
+        if(i2==i+1) {
+          vertexRep[vertexOld[i]] = vertexOld[i];
+        } else {
+          run.assign(vertexOld.begin()+i,vertexOld.begin()+i2);
+          sort(run.begin(),run.end(),fineLess);
+          int iRep = run[0];
+          for(size_t r=0;r<run.size();r++) {
+            if(r>0 && memcmp(&fine[3*run[r]],&fine[3*run[r-1]],12)!=0)
+              iRep = run[r];
+            vertexRep[run[r]] = iRep;
+          }
+        }
+        i = i2;
+      }
+    });
+
+  // 3) the representatives keep their relative order; their new indices
+  //    are computed by prefix sums over ranges of vertices, before those
+  //    of the merged vertices, whose representatives precede them
+  int nRV = Parallel::getNumberOfRanges(nThreads,nV);
+  vector<int> nRepRange(nRV,0);
+  Parallel::forRanges(nThreads,nV,[&](int k, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++)
+        if(vertexRep[iV]==iV) nRepRange[k]++;
+    });
+  int nVNew = 0;
+  for(int k=0;k<nRV;k++) {
+    int n = nRepRange[k]; nRepRange[k] = nVNew; nVNew += n;
+  }
+  if(nVNew==nV) return;
+  vector<int> vertexNew(nV);
+  Parallel::forRanges(nThreads,nV,[&](int k, int v0, int v1) {
+      for(int iV=v0,n=nRepRange[k];iV<v1;iV++)
+        if(vertexRep[iV]==iV) vertexNew[iV] = n++;
+    });
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++)
+        if(vertexRep[iV]!=iV) vertexNew[iV] = vertexNew[vertexRep[iV]];
+    });
+
+  // 4) keep the values of the representatives, and remap coordIndex
+  auto weldValues = [&](vector<float>& value, const int dim) {
+    vector<float> valueNew(dim*nVNew);
+    Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+        for(int iV=v0;iV<v1;iV++)
+          if(vertexRep[iV]==iV)
+            for(int j=0;j<dim;j++)
+              valueNew[dim*vertexNew[iV]+j] = value[dim*iV+j];
+      });
+    value.swap(valueNew);
+  };
+  weldValues(ifs.getCoord(),3);
+  if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getNormal().size()==UL(3*nV))
+    weldValues(ifs.getNormal(),3);
+  if(ifs.getColorBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getColor().size()==UL(3*nV))
+    weldValues(ifs.getColor(),3);
+  if(ifs.getTexCoordBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+     cifs.getTexCoord().size()==UL(2*nV))
+    weldValues(ifs.getTexCoord(),2);
+  vector<int>& coordIndexNew = ifs.getCoordIndex();
+  int nC = static_cast<int>(coordIndexNew.size());
+  Parallel::forRanges(nThreads,nC,[&](int /*k*/, int i0, int i1) {
+      for(int i=i0;i<i1;i++)
+        if(coordIndexNew[i]>=0) coordIndexNew[i] = vertexNew[coordIndexNew[i]];
+    });
+  ifs.setBBoxDirty();
+}
+
+// the Shapes under a Transform may share their geometry with Shapes
+// under other Transforms; each geometry is transformed once for each
+// Transform, and the Shapes under Transforms other than the one of the
+// first Shape found in the traversal get a copy of the geometry; all
+// the copies are made before any geometry is transformed, so that they
+// are copies of the untransformed original
+void SceneGraphProcessor::bakeTransforms(const int nThreads) {
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+
+  // 1) assign a geometry to each pair of geometry and Transform, and
+  //    propagate the show flags of the groups down to the Shapes
+  vector<bool> hidden(nNodes,false);
+  vector<Node*> leaves;
+  map<pair<Node*,int>,Node*> baked;
+  unordered_set<Node*> used;
+  vector<pair<Node*,int>> toBake;
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    Node* node = flat.getNode(iNode);
+    int iParent = flat.getParent(iNode);
+    hidden[iNode] = (iParent>=0 && hidden[iParent]);
+    SceneGraphFlat::Kind kind = flat.getKind(iNode);
+    if(kind==SceneGraphFlat::GROUP || kind==SceneGraphFlat::TRANSFORM) {
+      if(node->getShow()==false) hidden[iNode] = true;
+      continue;
+    }
+    leaves.push_back(node);
+    if(kind!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)node;
+    if(hidden[iNode]) shape->setShow(false);
+    int iTransform = flat.getTransform(iNode);
+    Node* geometry = shape->getGeometry();
+    if(geometry==(Node*)0) continue;
+    pair<Node*,int> key(geometry,iTransform);
+    map<pair<Node*,int>,Node*>::iterator i = baked.find(key);
+    if(i!=baked.end()) {
+      if(i->second!=geometry) shape->setGeometry(i->second);
+      continue;
+    }
+    node = geometry;
+    if(used.insert(geometry).second==false) {
+      node = _copyGeometry(geometry);
+      shape->setGeometry(node);
+    }
+    baked[key] = node;
+    if(iTransform>=0) toBake.push_back(make_pair(node,iTransform));
+  }
+
+  // 2) compose the world matrices top-down, in the pre-order of the
+  //    flattened scene graph, and transform each assigned geometry by
+  //    the world matrix of its Transform
+  vector<float> world;
+  if(toBake.size()>0) world.resize(16*size_t(nNodes));
+  float M[16];
+  for(int iNode=0;iNode<nNodes && toBake.size()>0;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::TRANSFORM) continue;
+    float* W = &world[16*size_t(iNode)];
+    ((Transform*)flat.getNode(iNode))->getMatrix(M);
+    int iTransform = flat.getTransform(iNode);
+    if(iTransform<0)
+      for(int i=0;i<16;i++) W[i] = M[i];
+    else
+      Transform::multiply(&world[16*size_t(iTransform)],M,W);
+  }
+  for(pair<Node*,int>& b : toBake) {
+    Node* node = b.first;
+    for(int i=0;i<16;i++) M[i] = world[16*size_t(b.second)+i];
+    if(node->isIndexedFaceSet()) {
+      IndexedFaceSet* ifs = (IndexedFaceSet*)node;
+      bool flip = _bakeTransform(M,ifs->getCoord(),ifs->getNormal(),nThreads);
+      // a reflection reverses the orientation of the faces
+      if(flip) ifs->getCcw() = !ifs->getCcw();
+      ifs->setBBoxDirty();
+    } else if(node->isIndexedLineSet()) {
+      IndexedLineSet* ils = (IndexedLineSet*)node;
+      vector<float> noNormal;
+      _bakeTransform(M,ils->getCoord(),noNormal,nThreads);
+      ils->setBBoxDirty();
+    }
+  }
 
-      i0=i1+1; iF++;
+  // 3) make the Shapes children of the root, in traversal order, and
+  //    delete the Group and Transform nodes, now empty
+  vector<Group*> groups;
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    SceneGraphFlat::Kind kind = flat.getKind(iNode);
+    if(kind==SceneGraphFlat::GROUP || kind==SceneGraphFlat::TRANSFORM) {
+      Group* group = (Group*)flat.getNode(iNode);
+      group->getChildren().clear();
+      groups.push_back(group);
     }
   }
+  for(Group* group : groups)
+    delete group;
+  _wrl.getChildren().clear();
+  for(Node* node : leaves)
+    _wrl.addChild(node);
+  _wrl.setBBoxDirty();
+}
+
+Node* SceneGraphProcessor::_copyGeometry(Node* node) {
+  if(node->isIndexedFaceSet()) {
+    IndexedFaceSet& ifs  = *((IndexedFaceSet*)node);
+    IndexedFaceSet* copy = new IndexedFaceSet();
+    copy->getCcw()             = ifs.getCcw();
+    copy->getConvex()          = ifs.getConvex();
+    copy->getCreaseangle()     = ifs.getCreaseangle();
+    copy->getSolid()           = ifs.getSolid();
+    copy->getNormalPerVertex() = ifs.getNormalPerVertex();
+    copy->getColorPerVertex()  = ifs.getColorPerVertex();
+    copy->getCoord()           = ifs.getCoord();
+    copy->getCoordIndex()      = ifs.getCoordIndex();
+    copy->getNormal()          = ifs.getNormal();
+    copy->getNormalIndex()     = ifs.getNormalIndex();
+    copy->getColor()           = ifs.getColor();
+    copy->getColorIndex()      = ifs.getColorIndex();
+    copy->getTexCoord()        = ifs.getTexCoord();
+    copy->getTexCoordIndex()   = ifs.getTexCoordIndex();
+    return copy;
+  } else /* if(node->isIndexedLineSet()) */ {
+    IndexedLineSet& ils  = *((IndexedLineSet*)node);
+    IndexedLineSet* copy = new IndexedLineSet();
+    copy->getCoord()           = ils.getCoord();
+    copy->getCoordIndex()      = ils.getCoordIndex();
+    copy->getColor()           = ils.getColor();
+    copy->getColorIndex()      = ils.getColorIndex();
+    copy->getColorPerVertex()  = ils.getColorPerVertex();
+    return copy;
+  }
+}
+
+bool SceneGraphProcessor::_bakeTransform
+(const float* M, vector<float>& coord, vector<float>& normal,
+ const int nThreads) {
+  // p |-> A*p+b, and n |-> cof(A)*n normalized, where cof(A), the
+  // matrix of cofactors, is det(A) times the inverse transpose of A
+  const float A[9] = {
+    M[0], M[1], M[ 2],
+    M[4], M[5], M[ 6],
+    M[8], M[9], M[10]
+  };
+  const float b[3] = { M[3], M[7], M[11] };
+  const float C[9] = {
+    A[4]*A[8]-A[5]*A[7], A[5]*A[6]-A[3]*A[8], A[3]*A[7]-A[4]*A[6],
+    A[2]*A[7]-A[1]*A[8], A[0]*A[8]-A[2]*A[6], A[1]*A[6]-A[0]*A[7],
+    A[1]*A[5]-A[2]*A[4], A[2]*A[3]-A[0]*A[5], A[0]*A[4]-A[1]*A[3]
+  };
+  float det = A[0]*C[0]+A[1]*C[1]+A[2]*C[2];
+
+  int nV = static_cast<int>(coord.size()/3);
+  Parallel::forRanges(nThreads,nV,[&](int /*k*/, int v0, int v1) {
+      for(int iV=v0;iV<v1;iV++) {
+        float* p = &coord[3*static_cast<size_t>(iV)];
+        float x = p[0], y = p[1], z = p[2];
+        p[0] = A[0]*x+A[1]*y+A[2]*z+b[0];
+        p[1] = A[3]*x+A[4]*y+A[5]*z+b[1];
+        p[2] = A[6]*x+A[7]*y+A[8]*z+b[2];
+      }
+    });
+
+  int nN = static_cast<int>(normal.size()/3);
+  Parallel::forRanges(nThreads,nN,[&](int /*k*/, int n0, int n1) {
+      for(int iN=n0;iN<n1;iN++) {
+        float* n = &normal[3*static_cast<size_t>(iN)];
+        float x = n[0], y = n[1], z = n[2];
+        Vec3f m(C[0]*x+C[1]*y+C[2]*z,
+                C[3]*x+C[4]*y+C[5]*z,
+                C[6]*x+C[7]*y+C[8]*z);
+        if(det<0.0f) { m.x = -m.x; m.y = -m.y; m.z = -m.z; }
+        m.normalize();
+        n[0] = m.x; n[1] = m.y; n[2] = m.z;
+      }
+    });
+
+  return (det<0.0f);
 }
 
 void SceneGraphProcessor::bboxAdd
-(int depth, float scale, bool isCube) {
+(int depth, float scale, bool isCube, bool occupied, const int nThreads) {
   const string name = "BOUNDING-BOX";
   Shape* shape = (Shape*)0;
   const Node*  node = _wrl.getChild(name);
@@ -374,6 +1074,7 @@ void SceneGraphProcessor::bboxAdd
   color.clear();
   colorIndex.clear();
   ils->setColorPerVertex(true);
+  ils->setBBoxDirty();
 
   _wrl.updateBBox();
   Vec3f& center = _wrl.getBBoxCenter();
@@ -421,6 +1122,14 @@ void SceneGraphProcessor::bboxAdd
     coordIndex.push_back(2); coordIndex.push_back(6); coordIndex.push_back(-1);
     coordIndex.push_back(3); coordIndex.push_back(7); coordIndex.push_back(-1);
 
+  } else if(occupied) {
+
+    OccupancyGrid grid(depth);
+    Vec3f min(x0,y0,z0);
+    Vec3f max(x1,y1,z1);
+    _bboxVoxelize(grid,min,max,nThreads);
+    _bboxOccupiedEdges(grid,min,max,coord,coordIndex,nThreads);
+
   } else {
 
     int N = 1<<depth;
@@ -476,189 +1185,546 @@ void SceneGraphProcessor::bboxAdd
     }
 
   }
+  ils->setBBoxDirty();
 }
 
-void SceneGraphProcessor::bboxRemove() {
-  vector<pNode>& children = _wrl.getChildren();
-  vector<pNode>::iterator i;
-  for(i=children.begin();i!=children.end();i++)
-    if((*i)->nameEquals("BOUNDING-BOX"))
-      break;
-  if(i!=children.end())
-    children.erase(i);
-}
-
-void SceneGraphProcessor::edgesAdd() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  const Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape  = (Shape*)node;
-      const Node* parent = shape->getParent();
-      Group* group = (Group*)parent;
-
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        IndexedFaceSet* ifs = (IndexedFaceSet*)node;
-
-        shape->setShow(false);
-
-        // compose the node name ???
-        string name = "EDGES";
-        node = group->getChild(name);
-        if(node==(Node*)0) {
-          shape = new Shape();
-          shape->setName(name);
-          Appearance* appearance = new Appearance();
-          shape->setAppearance(appearance);
-          Material* material = new Material();
-          // colors should be stored in WrlViewerData
-          Color edgeColor(1.0f,0.5f,0.0f);
-          material->setDiffuseColor(edgeColor);
-          appearance->setMaterial(material);
-          group->addChild(shape);
-        } else if(node->isShape()) {
-          shape = (Shape*)node;
-        } else /* if(node!=(Node*)0 && node->isShape()==false */ {
-          // throw exception ???
-        }
-        if(shape==(Shape*)0) { /* throw exception ??? */ return; }
-
-        IndexedLineSet* ils = (IndexedLineSet*)0;
-        node = shape->getGeometry();
-        if(node==(Node*)0) {
-          ils = new IndexedLineSet();
-          shape->setGeometry(ils);
-        } else if(node->isIndexedLineSet()) {
-          ils = (IndexedLineSet*)node;
-        } else /* if(node!=(Node*)0 && node->isIndexedLineSet()==false) */ {
-          // throw exception ???
-        }
-        
-        if(ils==(IndexedLineSet*)0) { /* throw exception ??? */ return; }
+// separating axis test of the triangle (p0,p1,p2) against the
+// axis-aligned cube of center c and half side h
+static bool _triangleBoxOverlap
+(const float* c, const float h, const float* p0, const float* p1, const float* p2) {
+  float v[3][3],e[3][3],a[3],n[3];
+  int i,j,k;
+  for(j=0;j<3;j++) {
+    v[0][j] = p0[j]-c[j];
+    v[1][j] = p1[j]-c[j];
+    v[2][j] = p2[j]-c[j];
+  }
+  // box face normals
+  for(j=0;j<3;j++) {
+    if(min(v[0][j],min(v[1][j],v[2][j]))> h) return false;
+    if(max(v[0][j],max(v[1][j],v[2][j]))<-h) return false;
+  }
+  for(i=0;i<3;i++)
+    for(j=0;j<3;j++)
+      e[i][j] = v[(i+1)%3][j]-v[i][j];
+  // triangle normal
+  n[0] = e[0][1]*e[1][2]-e[0][2]*e[1][1];
+  n[1] = e[0][2]*e[1][0]-e[0][0]*e[1][2];
+  n[2] = e[0][0]*e[1][1]-e[0][1]*e[1][0];
+  if(fabs(n[0]*v[0][0]+n[1]*v[0][1]+n[2]*v[0][2])>
+     h*(fabs(n[0])+fabs(n[1])+fabs(n[2]))) return false;
+  // cross products of the triangle edges and the box axes
+  for(i=0;i<3;i++) {
+    for(j=0;j<3;j++) {
+      a[j]       = 0.0f;
+      a[(j+1)%3] =  e[i][(j+2)%3];
+      a[(j+2)%3] = -e[i][(j+1)%3];
+      float r = h*(fabs(a[0])+fabs(a[1])+fabs(a[2]));
+      float pMin = 0.0f, pMax = 0.0f;
+      for(k=0;k<3;k++) {
+        float p = a[0]*v[k][0]+a[1]*v[k][1]+a[2]*v[k][2];
+        if(k==0 || p<pMin) pMin = p;
+        if(k==0 || p>pMax) pMax = p;
+      }
+      if(pMin>r || pMax<-r) return false;
+    }
+  }
+  return true;
+}
 
-        ils->clear();
+// tolerance, in cell units, of the voxelization tests
+static const float _voxelEps = 1.0e-3f;
+
+// appends to keys the cells of the block of 2^L cells per side with
+// minimum corner b which intersect the triangle (u0,u1,u2), in grid
+// coordinates; [i0,i1] is the range of cells spanned by the triangle
+static void _voxelizeBlock
+(const float* u0, const float* u1, const float* u2,
+ const int* i0, const int* i1, const int L, const int* b,
+ vector<uint64_t>& keys) {
+  int size = 1<<L;
+  for(int j=0;j<3;j++)
+    if(b[j]>i1[j] || b[j]+size<=i0[j]) return;
+  float h = 0.5f*static_cast<float>(size);
+  float c[3] = { b[0]+h, b[1]+h, b[2]+h };
+  if(_triangleBoxOverlap(c,h+_voxelEps,u0,u1,u2)==false) return;
+  if(L==0) {
+    keys.push_back(OccupancyGrid::getKey(b[0],b[1],b[2]));
+  } else {
+    int half = size>>1;
+    for(int k=0;k<8;k++) {
+      int bk[3] = { b[0]+((k   )&1)*half, b[1]+((k>>1)&1)*half, b[2]+((k>>2)&1)*half };
+      _voxelizeBlock(u0,u1,u2,i0,i1,L-1,bk,keys);
+    }
+  }
+}
 
-        vector<float>& coordIfs      = ifs->getCoord();
-        vector<int>&   coordIndexIfs = ifs->getCoordIndex();
+// appends to keys the cells of a grid of N cells per side which
+// intersect the triangle (u0,u1,u2), in grid coordinates; only the
+// blocks of a pointer-free octree which intersect the triangle are
+// visited, starting from the smallest one containing its bounding box
+static void _voxelizeTriangle
+(const float* u0, const float* u1, const float* u2, const int N,
+ vector<uint64_t>& keys) {
+  int i0[3],i1[3],b[3],j;
+  for(j=0;j<3;j++) {
+    float lo = min(u0[j],min(u1[j],u2[j]));
+    float hi = max(u0[j],max(u1[j],u2[j]));
+    if(hi<-_voxelEps || lo>N+_voxelEps) return;
+    i0[j] = (lo<0.0f)?0:(lo>=N)?N-1:static_cast<int>(lo);
+    i1[j] = (hi<0.0f)?0:(hi>=N)?N-1:static_cast<int>(hi);
+  }
+  if(i0[0]==i1[0] && i0[1]==i1[1] && i0[2]==i1[2]) {
+    keys.push_back(OccupancyGrid::getKey(i0[0],i0[1],i0[2]));
+    return;
+  }
+  int diff = (i0[0]^i1[0])|(i0[1]^i1[1])|(i0[2]^i1[2]);
+  int L = 0;
+  while((diff>>L)!=0) L++;
+  for(j=0;j<3;j++)
+    b[j] = (i0[j]>>L)<<L;
+  _voxelizeBlock(u0,u1,u2,i0,i1,L,b,keys);
+}
 
-        vector<float>& coordIls      = ils->getCoord();
-        vector<int>&   coordIndexIls = ils->getCoordIndex();
+void SceneGraphProcessor::_bboxVoxelize
+(OccupancyGrid& grid, const Vec3f& min, const Vec3f& max, const int nThreads) {
+  int N = grid.getResolution();
+  // grid coordinates, where the cell (ix,iy,iz) is the unit cube with
+  // minimum corner (ix,iy,iz); flat sides of the box map to 0
+  float o[3] = { min.x, min.y, min.z };
+  float s[3] = { max.x-min.x, max.y-min.y, max.z-min.z };
+  for(int j=0;j<3;j++)
+    s[j] = (s[j]>0.0f)?static_cast<float>(N)/s[j]:0.0f;
+  auto toGrid = [&o,&s](const float* p, float* u) {
+    u[0] = (p[0]-o[0])*s[0];
+    u[1] = (p[1]-o[1])*s[1];
+    u[2] = (p[2]-o[2])*s[2];
+  };
+
+  // each range appends its cells, sorted and without repetitions,
+  // so that the partial lists stay small
+  vector<uint64_t> keys;
+  vector<vector<uint64_t>> rangeKeys;
+  auto appendRangeKeys = [&keys,&rangeKeys]() {
+    for(vector<uint64_t>& rk : rangeKeys)
+      keys.insert(keys.end(),rk.begin(),rk.end());
+    rangeKeys.clear();
+  };
+  auto sortRangeKeys = [](vector<uint64_t>& rk) {
+    sort(rk.begin(),rk.end());
+    rk.erase(unique(rk.begin(),rk.end()),rk.end());
+  };
+
+  auto addPoints = [&](const vector<float>& coord) {
+    int nV = static_cast<int>(coord.size()/3);
+    rangeKeys.resize(Parallel::getNumberOfRanges(nThreads,nV));
+    Parallel::forRanges(nThreads,nV,[&](int k, int v0, int v1) {
+        vector<uint64_t>& rk = rangeKeys[k];
+        float u[3];
+        int   i[3],j;
+        for(int iV=v0;iV<v1;iV++) {
+          toGrid(&coord[3*static_cast<size_t>(iV)],u);
+          for(j=0;j<3;j++) {
+            if(u[j]<-_voxelEps || u[j]>N+_voxelEps) break;
+            i[j] = (u[j]<0.0f)?0:(u[j]>=N)?N-1:static_cast<int>(u[j]);
+          }
+          if(j==3) rk.push_back(OccupancyGrid::getKey(i[0],i[1],i[2]));
+        }
+        sortRangeKeys(rk);
+      });
+    appendRangeKeys();
+  };
+
+  // polygonal faces are split into triangle fans
+  auto addFaces = [&](const vector<float>& coord,
+                      const vector<int>& coordIndex,
+                      const vector<int>& faceFirst, const int nF) {
+    rangeKeys.resize(Parallel::getNumberOfRanges(nThreads,nF));
+    Parallel::forRanges(nThreads,nF,[&](int k, int f0, int f1) {
+        vector<uint64_t>& rk = rangeKeys[k];
+        float u0[3],u1[3],u2[3];
+        for(int iF=f0;iF<f1;iF++) {
+          int i0 = faceFirst[iF];
+          int i1 = faceFirst[iF+1]-1;
+          if(i1-i0<3) {
+            // points and segments are voxelized as degenerate triangles
+            if(i1<=i0) continue;
+            toGrid(&coord[3*static_cast<size_t>(coordIndex[i0  ])],u0);
+            toGrid(&coord[3*static_cast<size_t>(coordIndex[i1-1])],u1);
+            _voxelizeTriangle(u0,u1,u1,N,rk);
+            continue;
+          }
+          toGrid(&coord[3*static_cast<size_t>(coordIndex[i0])],u0);
+          toGrid(&coord[3*static_cast<size_t>(coordIndex[i0+1])],u2);
+          for(int i=i0+2;i<i1;i++) {
+            u1[0] = u2[0]; u1[1] = u2[1]; u1[2] = u2[2];
+            toGrid(&coord[3*static_cast<size_t>(coordIndex[i])],u2);
+            _voxelizeTriangle(u0,u1,u2,N,rk);
+          }
+        }
+        sortRangeKeys(rk);
+      });
+    appendRangeKeys();
+  };
+
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    Node* node = flat.getNode(iNode);
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE ||
+       node->nameEquals("BOUNDING-BOX")) continue;
+    node = ((Shape*)node)->getGeometry();
+    if(node==(Node*)0) continue;
+    if(node->isIndexedFaceSet()) {
+      const IndexedFaceSet* ifs = (const IndexedFaceSet*)node;
+      const vector<float>& coord      = ifs->getCoord();
+      const vector<int>&   coordIndex = ifs->getCoordIndex();
+      int nV = static_cast<int>(coord.size()/3);
+      vector<int> faceFirst;
+      int nF = _getFaceFirst(coordIndex,nV,faceFirst,nThreads);
+      if(nF>0)
+        addFaces(coord,coordIndex,faceFirst,nF);
+      else
+        addPoints(coord);
+    } else if(node->isIndexedLineSet()) {
+      addPoints(((const IndexedLineSet*)node)->getCoord());
+    }
+  }
 
-        coordIls.insert(coordIls.end(),
-                        coordIfs.begin(),coordIfs.end());
+  grid.setCells(keys,nThreads);
+}
 
-        int i,i0,i1,nV,iV,iV0,iV1,iF;
-        nV = static_cast<int>(coordIfs.size()/3);
-        for(iV=0;iV<nV;iV++) {
-          coordIls.push_back(coordIfs[3*iV  ]);
-          coordIls.push_back(coordIfs[3*iV+1]);
-          coordIls.push_back(coordIfs[3*iV+2]);
+void SceneGraphProcessor::_bboxOccupiedEdges
+(const OccupancyGrid& grid, const Vec3f& min, const Vec3f& max,
+ vector<float>& coord, vector<int>& coordIndex, const int nThreads) {
+  // - the 27 cells around each occupied cell are identified by the
+  //   slots s=(dx+1)+3*((dy+1)+3*(dz+1)), with the cell itself in
+  //   the slot 13
+  // - the corners c=cx+2*cy+4*cz of a cell are the vertices
+  //   (ix+cx,iy+cy,iz+cz), and its 12 edges join the corners c and
+  //   c|(1<<axis), for the 4 corners c with a zero bit axis
+  // - a grid vertex or edge is shared by up to 8 or 4 cells, and it is
+  //   emitted by the occupied one of smallest index
+  int N      = grid.getResolution();
+  int nCells = grid.getNumberOfCells();
+
+  // slots of the cells sharing each corner and each edge of a cell
+  const int stride[3] = { 1, 3, 9 };
+  int cornerSlot[8][8],edgeSlot[12][4],edgeCorner[12],edgeAxis[12];
+  int c,t,j,iEdge = 0;
+  for(c=0;c<8;c++)
+    for(t=0;t<8;t++)
+      for(j=0,cornerSlot[c][t]=0;j<3;j++)
+        cornerSlot[c][t] += (((c>>j)&1)+((t>>j)&1))*stride[j];
+  for(int axis=0;axis<3;axis++)
+    for(c=0;c<8;c++)
+      if(((c>>axis)&1)==0) {
+        for(t=0,j=0;t<8;t++)
+          if(((t>>axis)&1)==0)
+            edgeSlot[iEdge][j++] = cornerSlot[c][t]+stride[axis];
+        edgeCorner[iEdge] = c;
+        edgeAxis[iEdge]   = axis;
+        iEdge++;
+      }
+  auto getNeighbor = [&grid](const int* i, const int s) {
+    return grid.find(i[0]+s%3-1,i[1]+(s/3)%3-1,i[2]+s/9-1);
+  };
+  auto countBits = [](const uint64_t mask) {
+    return static_cast<int>(bitset<64>(mask).count());
+  };
+
+  // slots of the owners of the corners of each cell, in 5 bits per
+  // corner, and vertices and edges owned by each cell
+  vector<uint64_t> ownerSlot(nCells);
+  vector<uint8_t>  cornerMask(nCells);
+  vector<uint16_t> edgeMask(nCells);
+  Parallel::forRanges(nThreads,nCells,[&](int /*k*/, int c0, int c1) {
+      int nb[27],k,s,slot;
+      for(int iCell=c0;iCell<c1;iCell++) {
+        grid.getNeighbors(iCell,nb);
+        uint64_t owners = 0;
+        int cMask = 0, eMask = 0;
+        for(int iC=0;iC<8;iC++) {
+          for(k=0,slot=13;k<8;k++) {
+            s = cornerSlot[iC][k];
+            if(nb[s]>=0 && nb[s]<nb[slot]) slot = s;
+          }
+          if(slot==13) cMask |= 1<<iC;
+          owners |= static_cast<uint64_t>(slot)<<(5*iC);
         }
+        for(int iE=0;iE<12;iE++) {
+          for(k=0,slot=13;k<4;k++) {
+            s = edgeSlot[iE][k];
+            if(nb[s]>=0 && nb[s]<nb[slot]) slot = s;
+          }
+          if(slot==13) eMask |= 1<<iE;
+        }
+        ownerSlot[iCell]  = owners;
+        cornerMask[iCell] = static_cast<uint8_t>(cMask);
+        edgeMask[iCell]   = static_cast<uint16_t>(eMask);
+      }
+    });
+
+  vector<int> vertexFirst(nCells+1);
+  vector<int> edgeFirst(nCells+1);
+  vertexFirst[0] = edgeFirst[0] = 0;
+  for(int iCell=0;iCell<nCells;iCell++) {
+    vertexFirst[iCell+1] = vertexFirst[iCell]+countBits(cornerMask[iCell]);
+    edgeFirst[iCell+1]   = edgeFirst[iCell]+countBits(edgeMask[iCell]);
+  }
 
-        for(iF=i0=i1=0;i1<(int)coordIndexIfs.size();i1++) {
-          if(coordIndexIfs[i1]<0) {
-            iV0 = coordIndexIfs[i1-1];
-            for(i=i0;i<i1;i++) {
-              iV1 = coordIndexIfs[i];
-              coordIndexIls.push_back(iV0);
-              coordIndexIls.push_back(iV1);
-              coordIndexIls.push_back(-1);
-              iV0 = iV1;
+  coord.resize(3*static_cast<size_t>(vertexFirst[nCells]));
+  coordIndex.resize(3*static_cast<size_t>(edgeFirst[nCells]));
+  float lo[3] = { min.x, min.y, min.z };
+  float hi[3] = { max.x, max.y, max.z };
+  Parallel::forRanges(nThreads,nCells,[&](int /*k*/, int c0, int c1) {
+      int iV[8],i[3],jj;
+      for(int iCell=c0;iCell<c1;iCell++) {
+        grid.getCell(iCell,i[0],i[1],i[2]);
+        for(int iC=0;iC<8;iC++) {
+          // the corner iC of this cell is the corner cOwner of its owner
+          int s = static_cast<int>((ownerSlot[iCell]>>(5*iC))&31);
+          int iOwner = (s==13)?iCell:getNeighbor(i,s);
+          int cOwner = 0;
+          for(jj=0;jj<3;jj++,s/=3)
+            cOwner |= (((iC>>jj)&1)+1-s%3)<<jj;
+          iV[iC] = vertexFirst[iOwner]+
+            countBits(cornerMask[iOwner]&((1<<cOwner)-1));
+          if(iOwner==iCell) {
+            size_t k = 3*static_cast<size_t>(iV[iC]);
+            for(jj=0;jj<3;jj++) {
+              float tj = static_cast<float>(i[jj]+((iC>>jj)&1));
+              coord[k+jj] = ((N-tj)*lo[jj]+tj*hi[jj])/static_cast<float>(N);
             }
-            iF++; i0 = i1+1;
           }
         }
+        size_t k = 3*static_cast<size_t>(edgeFirst[iCell]);
+        for(int iE=0;iE<12;iE++)
+          if((edgeMask[iCell]>>iE)&1) {
+            coordIndex[k++] = iV[edgeCorner[iE]];
+            coordIndex[k++] = iV[edgeCorner[iE]|(1<<edgeAxis[iE])];
+            coordIndex[k++] = -1;
+          }
+      }
+    });
+}
 
+void SceneGraphProcessor::bboxRemove() {
+  _wrl.removeChildren("BOUNDING-BOX",false);
+}
 
-      }
+void SceneGraphProcessor::edgesAdd(const int nThreads) {
+  // EDGES shapes are added to the graph as it is processed, so the
+  // shapes are collected first
+  vector<Shape*> shapeIfs;
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedFaceSet()) shapeIfs.push_back(shape);
+  }
+
+  const Node* node;
+  for(Shape* shape : shapeIfs) {
+    const Node* parent = shape->getParent();
+    Group* group = (Group*)parent;
+    IndexedFaceSet* ifs = (IndexedFaceSet*)(shape->getGeometry());
+
+    shape->setShow(false);
+
+    // compose the node name ???
+    string name = "EDGES";
+    node = group->getChild(name);
+    if(node==(Node*)0) {
+      shape = new Shape();
+      shape->setName(name);
+      Appearance* appearance = new Appearance();
+      shape->setAppearance(appearance);
+      Material* material = new Material();
+      // colors should be stored in WrlViewerData
+      Color edgeColor(1.0f,0.5f,0.0f);
+      material->setDiffuseColor(edgeColor);
+      appearance->setMaterial(material);
+      group->addChild(shape);
+    } else if(node->isShape()) {
+      shape = (Shape*)node;
+    } else /* if(node!=(Node*)0 && node->isShape()==false */ {
+      // throw exception ???
     }
+    if(shape==(Shape*)0) { /* throw exception ??? */ return; }
+
+    IndexedLineSet* ils = (IndexedLineSet*)0;
+    node = shape->getGeometry();
+    if(node==(Node*)0) {
+      ils = new IndexedLineSet();
+      shape->setGeometry(ils);
+    } else if(node->isIndexedLineSet()) {
+      ils = (IndexedLineSet*)node;
+    } else /* if(node!=(Node*)0 && node->isIndexedLineSet()==false) */ {
+      // throw exception ???
+    }
+    
+    if(ils==(IndexedLineSet*)0) { /* throw exception ??? */ return; }
+
+    ils->clear();
+    _edgesAdd(*ifs,*ils,nThreads);
   }
 }
 
+// each edge of the IndexedFaceSet is emitted once, as a polyline with
+// two vertices, in the order defined by HalfEdges; the coordinates are
+// copied once, and shared by all the polylines
+void SceneGraphProcessor::_edgesAdd
+(IndexedFaceSet& ifs, IndexedLineSet& ils, const int nThreads) {
+  const IndexedFaceSet& ifsConst = ifs;
+  const vector<int>& coordIndexIfs = ifsConst.getCoordIndex();
+  vector<int>&       coordIndexIls = ils.getCoordIndex();
+
+  int nV = ifs.getNumberOfCoord();
+  vector<int> faceFirst;
+  if(_getFaceFirst(coordIndexIfs,nV,faceFirst,nThreads)<=0) return;
+  // HalfEdges expects the last face to be terminated
+  vector<int> coordIndexTerminated;
+  if(coordIndexIfs.back()>=0) {
+    coordIndexTerminated = coordIndexIfs;
+    coordIndexTerminated.push_back(-1);
+  }
+  const vector<int>& cIndex =
+    (coordIndexTerminated.size()>0)?coordIndexTerminated:coordIndexIfs;
+
+  HalfEdges halfEdges(nV,cIndex,nThreads);
+  int nE = halfEdges.getNumberOfEdges();
+  // the IndexedLineSet shares the vertices of the IndexedFaceSet
+  ils.setCoordArray(ifs.getCoordArray());
+  coordIndexIls.resize(3*static_cast<size_t>(nE));
+  Parallel::forRanges(nThreads,nE,[&](int /*k*/, int e0, int e1) {
+      for(int iE=e0;iE<e1;iE++) {
+        size_t j = 3*static_cast<size_t>(iE);
+        coordIndexIls[j  ] = halfEdges.getVertex0(iE);
+        coordIndexIls[j+1] = halfEdges.getVertex1(iE);
+        coordIndexIls[j+2] = -1;
+      }
+    });
+  ils.setBBoxDirty();
+}
+
 void SceneGraphProcessor::edgesRemove() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape  = (Shape*)node;
-      const Node* parent = shape->getParent();
-      Group* group = (Group*)parent;
-      vector<pNode>& children = group->getChildren();
-      vector<pNode>::iterator i;
-      do {
-        for(i=children.begin();i!=children.end();i++)
-          if((*i)->nameEquals("EDGES"))
-            break;
-        if(i!=children.end()) {
-          children.erase(i);
-          i=children.begin();
-        }
-      } while(i!=children.end());
-    }
+  // collect the groups containing shapes before modifying them
+  vector<Group*> groups;
+  unordered_set<const Node*> groupSet;
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    const Node* parent = flat.getNode(iNode)->getParent();
+    if(groupSet.insert(parent).second) groups.push_back((Group*)parent);
   }
+  for(Group* group : groups)
+    group->removeChildren("EDGES",false);
 }
 
 void SceneGraphProcessor::shapeIndexedFaceSetShow() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        shape->setShow(true);
-      }
-    }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedFaceSet()) shape->setShow(true);
   }
 }
 
 void SceneGraphProcessor::shapeIndexedFaceSetHide() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        shape->setShow(false);
-      }
-    }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedFaceSet()) shape->setShow(false);
   }
 }
 
 void SceneGraphProcessor::shapeIndexedLineSetShow() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedLineSet()) {
-        shape->setShow(true);
-      }
-    }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedLineSet()) shape->setShow(true);
   }
 }
 
 void SceneGraphProcessor::shapeIndexedLineSetHide() {
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedLineSet()) {
-        shape->setShow(false);
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedLineSet()) shape->setShow(false);
+  }
+}
+
+SceneSummary::SceneSummary():
+  hasBBox(false),
+  hasEdges(false),
+  hasIndexedFaceSetFaces(false),
+  hasIndexedFaceSetNormalNone(false),
+  hasIndexedFaceSetNormalPerFace(false),
+  hasIndexedFaceSetNormalPerVertex(false),
+  hasIndexedFaceSetNormalPerCorner(false),
+  hasIndexedLineSetColorNone(false),
+  hasIndexedLineSetColorPerVertex(false),
+  hasIndexedLineSetColorPerPolyline(false),
+  hasIndexedFaceSetShown(false),
+  hasIndexedFaceSetHidden(false),
+  hasIndexedLineSetShown(false),
+  hasIndexedLineSetHidden(false),
+  points((Shape*)0),
+  edges((Shape*)0),
+  surface((Shape*)0) {
+}
+
+void SceneGraphProcessor::getSceneSummary(SceneSummary& summary) {
+  summary = SceneSummary();
+  summary.hasBBox = hasBBox();
+
+  class SummaryVisitor : public SceneGraphVisitor {
+  public:
+    SceneSummary& summary;
+    SummaryVisitor(SceneSummary& s):summary(s) { }
+    using SceneGraphVisitor::visit;
+    void visit(Shape& shape, int /*iNode*/) {
+      summary.hasEdges                |= _hasEdges(shape);
+      summary.hasIndexedFaceSetShown  |= _hasIndexedFaceSetShown(shape);
+      summary.hasIndexedFaceSetHidden |= _hasIndexedFaceSetHidden(shape);
+      summary.hasIndexedLineSetShown  |= _hasIndexedLineSetShown(shape);
+      summary.hasIndexedLineSetHidden |= _hasIndexedLineSetHidden(shape);
+
+      if(summary.points==(Shape*)0 && shape.nameEquals("POINTS"))
+        summary.points = &shape;
+      if(summary.edges==(Shape*)0 && shape.nameEquals("EDGES"))
+        summary.edges = &shape;
+      if(summary.surface==(Shape*)0 && shape.nameEquals("SURFACE"))
+        summary.surface = &shape;
+
+      if(shape.hasGeometryIndexedFaceSet()) {
+        IndexedFaceSet& ifs = *(IndexedFaceSet*)(shape.getGeometry());
+        summary.hasIndexedFaceSetFaces           |= _hasFaces(ifs);
+        summary.hasIndexedFaceSetNormalNone      |= _hasNormalNone(ifs);
+        summary.hasIndexedFaceSetNormalPerFace   |= _hasNormalPerFace(ifs);
+        summary.hasIndexedFaceSetNormalPerVertex |= _hasNormalPerVertex(ifs);
+        summary.hasIndexedFaceSetNormalPerCorner |= _hasNormalPerCorner(ifs);
+      } else if(shape.hasGeometryIndexedLineSet()) {
+        IndexedLineSet& ils = *(IndexedLineSet*)(shape.getGeometry());
+        summary.hasIndexedLineSetColorNone        |= _hasColorNone(ils);
+        summary.hasIndexedLineSetColorPerVertex   |= _hasColorPerVertex(ils);
+        summary.hasIndexedLineSetColorPerPolyline |= _hasColorPerPolyline(ils);
       }
     }
-  }
+  };
+
+  SummaryVisitor visitor(summary);
+  _wrl.getFlat().traverse(visitor);
 }
 
 bool SceneGraphProcessor::hasBBox() {
@@ -666,51 +1732,41 @@ bool SceneGraphProcessor::hasBBox() {
 }
 
 bool SceneGraphProcessor::_hasShapeProperty(Shape::Property p) {
-  bool value = false;
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while(value==false && (node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape& shape = *(Shape*)node;
-      value = p(shape);
-    }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    if(p(*(Shape*)flat.getNode(iNode))) return true;
   }
-  return value;
+  return false;
 }
 
 bool SceneGraphProcessor::_hasIndexedFaceSetProperty(IndexedFaceSet::Property p) {
-  bool value = false;
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while(value==false && (node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      if(shape->hasGeometryIndexedFaceSet()) {
-        IndexedFaceSet& ifs = *(IndexedFaceSet*)(shape->getGeometry());
-        value = p(ifs);
-      }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedFaceSet()) {
+      IndexedFaceSet& ifs = *(IndexedFaceSet*)(shape->getGeometry());
+      if(p(ifs)) return true;
     }
   }
-  return value;
+  return false;
 }
 
 bool SceneGraphProcessor::_hasIndexedLineSetProperty(IndexedLineSet::Property p) {
-  bool value = false;
-  SceneGraphTraversal traversal(_wrl);
-  traversal.start();
-  Node* node;
-  while(value==false && (node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      if(shape->hasGeometryIndexedLineSet()) {
-        IndexedLineSet& ils = *(IndexedLineSet*)(shape->getGeometry());
-        value = p(ils);
-      }
+  SceneGraphFlat& flat = _wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Shape* shape = (Shape*)flat.getNode(iNode);
+    if(shape->hasGeometryIndexedLineSet()) {
+      IndexedLineSet& ils = *(IndexedLineSet*)(shape->getGeometry());
+      if(p(ils)) return true;
     }
   }
-  return value;
+  return false;
 }
 
 bool SceneGraphProcessor::_hasFaces(IndexedFaceSet& ifs) {
@@ -882,13 +1938,7 @@ bool SceneGraphProcessor::hasIndexedLineSetHidden() {
 }
 
 void SceneGraphProcessor::removeSceneGraphChild(const string& name) {
-  vector<pNode>& children = _wrl.getChildren();
-  vector<pNode>::iterator i;
-  for(i=children.begin();i!=children.end();i++)
-    if((*i)->nameEquals(name))
-      break;
-  if(i!=children.end())
-    children.erase(i);
+  _wrl.removeChildren(name,false);
 }
 
 void SceneGraphProcessor::pointsRemove() {
@@ -36,10 +36,46 @@
 #define _SceneGraphProcessor_hpp_
 
 #include <iostream>
+#include <functional>
 #include "SceneGraph.hpp"
 #include "Shape.hpp"
 #include "IndexedFaceSet.hpp"
 #include "IndexedLineSet.hpp"
+
+class OccupancyGrid;
+
+// values of the has*() properties of SceneGraphProcessor, and the
+// Shape nodes created by the tools, all computed in a single traversal
+// of the scene graph by SceneGraphProcessor::getSceneSummary()
+class SceneSummary {
+
+public:
+
+  SceneSummary();
+
+  bool   hasBBox;
+  bool   hasEdges;
+
+  bool   hasIndexedFaceSetFaces;
+  bool   hasIndexedFaceSetNormalNone;
+  bool   hasIndexedFaceSetNormalPerFace;
+  bool   hasIndexedFaceSetNormalPerVertex;
+  bool   hasIndexedFaceSetNormalPerCorner;
+
+  bool   hasIndexedLineSetColorNone;
+  bool   hasIndexedLineSetColorPerVertex;
+  bool   hasIndexedLineSetColorPerPolyline;
+
+  bool   hasIndexedFaceSetShown;
+  bool   hasIndexedFaceSetHidden;
+  bool   hasIndexedLineSetShown;
+  bool   hasIndexedLineSetHidden;
+
+  // first Shape nodes named POINTS, EDGES, and SURFACE, or null
+  Shape* points;
+  Shape* edges;
+  Shape* surface;
+};
 
 class SceneGraphProcessor {
 
@@ -48,17 +84,49 @@ public:
   SceneGraphProcessor(SceneGraph& wrl);
   ~SceneGraphProcessor();
 
-  void normalClear();
-  void normalInvert();
-  void computeNormalPerFace();
-  void computeNormalPerVertex();
-  void computeNormalPerCorner();
+  // the operations on IndexedFaceSets are applied to all the
+  // IndexedFaceSets in the scene graph using nThreads threads, or all
+  // the available cores if nThreads<=0; small IndexedFaceSets are
+  // processed concurrently, and large ones are split among all the
+  // threads; the result does not depend on nThreads
 
-  void bboxAdd(int depth=0, float scale=1.0f, bool isCube=true);
+  void normalClear(const int nThreads=1);
+  void normalInvert(const int nThreads=1);
+  void computeNormalPerFace(const int nThreads=1);
+
+  // weighting of the face normals accumulated into the vertex normals:
+  // by face area, or by the angle of the face at the vertex
+  enum NormalWeighting {
+    NW_AREA = 0,
+    NW_ANGLE
+  };
+
+  void computeNormalPerVertex(const int nThreads=1,
+                              const NormalWeighting weighting=NW_AREA);
+
+  // one normal per smoothing group of corners around each vertex,
+  // indexed by normalIndex; the faces incident to a regular edge are
+  // in the same smoothing group if the angle between their normals is
+  // less than the creaseAngle of the IndexedFaceSet
+  void computeNormalPerCorner(const int nThreads=1);
+
+  // adds a Shape named BOUNDING-BOX with the edges of a grid of
+  // 2^depth cells per side over the bounding box of the scene, made a
+  // cube if isCube is true, and scaled about its center; if occupied
+  // is true, only the edges of the cells which contain points, or
+  // intersect faces, of the scene are added, each one once, with the
+  // occupied cells voxelized by nThreads threads, or all the
+  // available cores if nThreads<=0
+  void bboxAdd(int depth=0, float scale=1.0f, bool isCube=true,
+               bool occupied=false, const int nThreads=1);
   void bboxRemove();
   bool hasBBox();
 
-  void edgesAdd();
+  // adds to the parent of each Shape with an IndexedFaceSet geometry a
+  // Shape named EDGES with an IndexedLineSet containing each edge of
+  // the mesh once; large meshes are processed by nThreads threads, or
+  // all the available cores if nThreads<=0
+  void edgesAdd(const int nThreads=1);
   void edgesRemove();
   bool hasEdges();
 
@@ -82,6 +150,41 @@ public:
   void shapeIndexedLineSetShow();
   void shapeIndexedLineSetHide();
 
+  // fills summary visiting each node once; the face counts of the
+  // IndexedFaceSets are cached, so that the cost is proportional to
+  // the number of nodes, rather than to the size of the scene
+  void getSceneSummary(SceneSummary& summary);
+
+  // reorders the vertices of each IndexedFaceSet along a Morton
+  // curve over the bounding box of its coordinates, and its faces in
+  // increasing order of their first vertex, to improve the locality of
+  // the passes which access coord through coordIndex; coordIndex, the
+  // other index arrays, and the per-vertex and per-face properties
+  // are remapped consistently; the work is split among nThreads
+  // threads, or all the available cores if nThreads<=0, and the
+  // result does not depend on nThreads
+  void spatialReorder(const int nThreads=1);
+
+  // merges the vertices of each IndexedFaceSet which have bitwise
+  // identical coordinates, if tolerance<=0, or which fall in the same
+  // cell of a grid with cells of side tolerance, otherwise, into the
+  // first one of them; coord and the per-vertex properties keep only
+  // the remaining vertices, in their original order, and coordIndex is
+  // remapped; faces which become degenerate are not removed; threads
+  // are used as in spatialReorder(), and the result does not depend
+  // on nThreads
+  void weldVertices(const float tolerance=0.0f, const int nThreads=1);
+
+  // applies to the coordinates and normals of each Shape the world
+  // matrix of its enclosing Transform, makes all the Shapes children
+  // of the root, and deletes the Group and Transform nodes; the Shapes
+  // under hidden groups are hidden; the vertices are transformed by
+  // nThreads threads, or all the available cores if nThreads<=0
+  void bakeTransforms(const int nThreads=1);
+
+  // bboxRemove(), edgesRemove() and these remove all the children with
+  // the given name in a single pass; the removed Shapes are detached
+  // but not deleted, since the viewer may still refer to them
   void removeSceneGraphChild(const string& name);
   void pointsRemove();
   void surfaceRemove();
@@ -91,17 +194,59 @@ private:
 
   SceneGraph&    _wrl;
 
-  void        _applyToIndexedFaceSet(IndexedFaceSet::Operator p);
+  // applies o(ifs,nThreadsIfs) to each IndexedFaceSet in the scene
+  // graph, once even if it is shared by several Shape nodes, where
+  // nThreadsIfs is the number of threads the operator may use
+  void        _applyToIndexedFaceSet
+              (const function<void(IndexedFaceSet&,int)>& o, const int nThreads);
 
   // IndexedFaceSet::Operator
   static void _normalClear(IndexedFaceSet& ifs);
   static void _normalInvert(IndexedFaceSet& ifs);
   static void _computeNormalPerFace(IndexedFaceSet& ifs);
-  static void _computeNormalPerVertex(IndexedFaceSet& ifs);
-  static void _computeNormalPerCorner(IndexedFaceSet& ifs);
+  static void _computeNormalPerVertex(IndexedFaceSet& ifs, const int nThreads,
+                                     const NormalWeighting weighting);
+  static void _computeNormalPerCorner(IndexedFaceSet& ifs, const int nThreads);
+
+  // adds to grid the cells of the box [min,max] which contain vertices
+  // of the IndexedLineSets, or of the IndexedFaceSets without faces, or
+  // which intersect faces of the IndexedFaceSets
+  void        _bboxVoxelize(OccupancyGrid& grid,
+                            const Vec3f& min, const Vec3f& max,
+                            const int nThreads);
+  // fills coord and coordIndex with the vertices and edges of the
+  // occupied cells of the grid over the box [min,max], each one once
+  static void _bboxOccupiedEdges(const OccupancyGrid& grid,
+                                 const Vec3f& min, const Vec3f& max,
+                                 vector<float>& coord, vector<int>& coordIndex,
+                                 const int nThreads);
+
+  // bounding box [bMin,bMax] of the first nV>0 vertices of coord,
+  // reduced over ranges of vertices
+  static void _getCoordBBox(const vector<float>& coord, const int nV,
+                            float bMin[3], float bMax[3], const int nThreads);
+  static void _spatialReorder(IndexedFaceSet& ifs, const int nThreads);
+  static void _weldVertices(IndexedFaceSet& ifs, const float tolerance,
+                            const int nThreads);
+  // applies the affine map M to coord and its inverse transpose to
+  // normal; returns true if M reverses orientation
+  static bool _bakeTransform(const float* M, vector<float>& coord,
+                             vector<float>& normal, const int nThreads);
+  // new IndexedFaceSet or IndexedLineSet with the fields of node
+  static Node* _copyGeometry(Node* node);
+  static void _edgesAdd(IndexedFaceSet& ifs, IndexedLineSet& ils,
+                        const int nThreads);
+
+  // fills faceFirst so that face iF occupies the positions
+  // faceFirst[iF]<=i<faceFirst[iF+1] of coordIndex, including its
+  // separator, and returns the number of faces; an unterminated last
+  // face is closed by a virtual separator at coordIndex.size(); returns
+  // -1 if coordIndex contains indices out of the range [-1,nV)
+  static int  _getFaceFirst(const vector<int>& coordIndex, const int nV,
+                            vector<int>& faceFirst, const int nThreads);
 
   static void _computeFaceNormal
-              (vector<float>& coord, vector<int>&   coordIndex,
+              (const vector<float>& coord, const vector<int>& coordIndex,
                int i0, int i1, Vec3f& n, bool normalize);
 
   bool        _hasShapeProperty(Shape::Property p);
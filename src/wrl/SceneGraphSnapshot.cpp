@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:41:04 taubin>
+//------------------------------------------------------------------------
+//
+// SceneGraphSnapshot.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <unordered_set>
+#include "SceneGraphSnapshot.hpp"
+#include "SceneGraphFlat.hpp"
+
+SceneGraphSnapshot::SceneGraphSnapshot(SceneGraph& wrl):
+  _wrl(wrl) {
+  // geometry nodes shared by several Shapes are recorded once
+  unordered_set<Node*> recorded;
+  SceneGraphFlat& flat = wrl.getFlat();
+  int nNodes = flat.getNumberOfNodes();
+  for(int iNode=0;iNode<nNodes;iNode++) {
+    if(flat.getKind(iNode)!=SceneGraphFlat::SHAPE) continue;
+    Node* node = ((Shape*)flat.getNode(iNode))->getGeometry();
+    if(node==(Node*)0 || recorded.insert(node).second==false) continue;
+    if(node->isIndexedFaceSet()) {
+      IndexedFaceSet* ifs = (IndexedFaceSet*)node;
+      ifs->ref((const Node*)0);
+      _ifs.push_back(ifs);
+      _ifsSnapshot.push_back(IndexedFaceSet::Snapshot());
+      ifs->getSnapshot(_ifsSnapshot.back());
+    } else if(node->isIndexedLineSet()) {
+      IndexedLineSet* ils = (IndexedLineSet*)node;
+      ils->ref((const Node*)0);
+      _ils.push_back(ils);
+      _ilsSnapshot.push_back(IndexedLineSet::Snapshot());
+      ils->getSnapshot(_ilsSnapshot.back());
+    }
+  }
+}
+
+SceneGraphSnapshot::~SceneGraphSnapshot() {
+  for(IndexedFaceSet* ifs : _ifs)
+    Node::unref(ifs,(const Node*)0);
+  for(IndexedLineSet* ils : _ils)
+    Node::unref(ils,(const Node*)0);
+}
+
+int SceneGraphSnapshot::getNumberOfNodes() const {
+  return static_cast<int>(_ifs.size()+_ils.size());
+}
+
+void SceneGraphSnapshot::restore() const {
+  for(size_t i=0;i<_ifs.size();i++)
+    _ifs[i]->setSnapshot(_ifsSnapshot[i]);
+  for(size_t i=0;i<_ils.size();i++)
+    _ils[i]->setSnapshot(_ilsSnapshot[i]);
+}
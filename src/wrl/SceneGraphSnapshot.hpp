@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:41:04 taubin>
+//------------------------------------------------------------------------
+//
+// SceneGraphSnapshot.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// Values of the fields of the IndexedFaceSet and IndexedLineSet nodes
+// of a SceneGraph. Taking a snapshot does not copy the arrays, which
+// are shared with the nodes until either side modifies them, so that
+// an operation which modifies some of the arrays only pays for copying
+// those. The geometry nodes are referenced by the snapshot, so that
+// they are not deleted while the snapshot exists. Changes to the
+// structure of the graph are not recorded.
+//
+// Use as follows
+//
+// SceneGraphSnapshot* before = new SceneGraphSnapshot(wrl);
+// processor.computeNormalPerVertex();
+// before->restore(); // undo
+// delete before;
+
+#ifndef _SceneGraphSnapshot_h_
+#define _SceneGraphSnapshot_h_
+
+#include <vector>
+#include "SceneGraph.hpp"
+#include "IndexedFaceSet.hpp"
+#include "IndexedLineSet.hpp"
+
+using namespace std;
+
+class SceneGraphSnapshot {
+
+public:
+
+  SceneGraphSnapshot(SceneGraph& wrl);
+  ~SceneGraphSnapshot();
+
+  SceneGraph& getSceneGraph() { return _wrl; }
+  int         getNumberOfNodes() const;
+
+  // sets the fields of the geometry nodes back to the recorded values
+  void        restore() const;
+
+private:
+
+  SceneGraph&                      _wrl;
+  vector<IndexedFaceSet*>          _ifs;
+  vector<IndexedFaceSet::Snapshot> _ifsSnapshot;
+  vector<IndexedLineSet*>          _ils;
+  vector<IndexedLineSet::Snapshot> _ilsSnapshot;
+};
+
+#endif /* _SceneGraphSnapshot_h_ */
@@ -42,6 +42,8 @@ Shape::Shape():
 }
 
 Shape::~Shape() {
+  Node::unref(_appearance,this);
+  Node::unref(_geometry,this);
 }
 
 Node* Shape::getAppearance() {
@@ -101,13 +103,22 @@ bool Shape::hasGeometryUnsupported() {
 }
 
 void Shape::setAppearance(Node* node) {
-  node->setParent(this);
+  if(node!=(Node*)0) node->ref(this);
+  Node::unref(_appearance,this);
   _appearance = node;
+  _notifyRoot();
 }
 
 void Shape::setGeometry(Node* node) {
-  node->setParent(this);
+  if(node!=(Node*)0) node->ref(this);
+  Node::unref(_geometry,this);
   _geometry = node;
+  setBBoxDirty();
+  _notifyRoot();
+}
+
+bool Shape::_computeBBox(Vec3f& min, Vec3f& max) {
+  return (_geometry!=(Node*)0 && _geometry->getBBox(min,max));
 }
 
 void Shape::printInfo(string indent) {
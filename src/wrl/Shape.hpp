@@ -71,6 +71,10 @@ public:
   typedef void    (*Operator)(Shape& shape);
   
   virtual void    printInfo(string indent);
+
+protected:
+
+  virtual bool    _computeBBox(Vec3f& min, Vec3f& max);
 };
 
 #endif /* _Shape_h_ */
@@ -41,7 +41,8 @@ Transform::Transform():
   _rotation(0.0f,0.0f,1.0f,0.0f),
   _scale(1.0f,1.0f,1.0f),
   _scaleOrientation(0.0f,0.0f,1.0f,0.0f),
-  _translation(0.0f,0.0f,0.0f) {
+  _translation(0.0f,0.0f,0.0f),
+  _matrixDirty(true) {
 }
 
 Transform::~Transform() {
@@ -54,21 +55,46 @@ Vec3f&    Transform::getScale()                      {  return            _scale
 Rotation& Transform::getScaleOrientation()           {  return _scaleOrientation; }
 Vec3f&    Transform::getTranslation()                {  return      _translation; }
 
-void Transform::setCenter(Vec3f& value)              {           _center = value; }
-void Transform::setRotation(Rotation& value)         {         _rotation = value; }
-void Transform::setScale(Vec3f& value)               {            _scale = value; }
-void Transform::setScaleOrientation(Rotation& value) { _scaleOrientation = value; }
-void Transform::setTranslation(Vec3f& value)         {      _translation = value; }
+void Transform::setCenter(Vec3f& value)              {           _center = value; setMatrixDirty(); }
+void Transform::setRotation(Rotation& value)         {         _rotation = value; setMatrixDirty(); }
+void Transform::setScale(Vec3f& value)               {            _scale = value; setMatrixDirty(); }
+void Transform::setScaleOrientation(Rotation& value) { _scaleOrientation = value; setMatrixDirty(); }
+void Transform::setTranslation(Vec3f& value)         {      _translation = value; setMatrixDirty(); }
 
 void Transform::setRotation(Vec4f& value) {
   _rotation = value;
+  setMatrixDirty();
 }
 
 void Transform::setScaleOrientation(Vec4f& value) {
   _scaleOrientation = value;
+  setMatrixDirty();
+}
+
+void Transform::setMatrixDirty() {
+  _matrixDirty = true;
+  setBBoxDirty();
 }
 
 void Transform::getMatrix(float* M /*[16]*/) {
+  if(_matrixDirty) {
+    _computeMatrix(_matrix);
+    _matrixDirty = false;
+  }
+  for(int i=0;i<16;i++) M[i] = _matrix[i];
+}
+
+void Transform::multiply(const float* A, const float* B, float* W) {
+  for(int i=0;i<4;i++)
+    for(int j=0;j<4;j++) {
+      float w = 0.0f;
+      for(int k=0;k<4;k++)
+        w += A[4*i+k]*B[4*k+j];
+      W[4*i+j] = w;
+    }
+}
+
+void Transform::_computeMatrix(float* M /*[16]*/) {
   M[ 0] = 1.0f; M[ 1] = 0.0f; M[ 2] = 0.0f; M[ 3] = 0.0f;
   M[ 4] = 0.0f; M[ 5] = 1.0f; M[ 6] = 0.0f; M[ 7] = 0.0f;
   M[ 8] = 0.0f; M[ 9] = 0.0f; M[10] = 1.0f; M[11] = 0.0f;
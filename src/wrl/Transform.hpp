@@ -63,6 +63,10 @@ private:
   Rotation      _scaleOrientation; // 0 0 1 0
   Vec3f         _translation;      // 0 0 0
 
+  // matrix of this Transform, valid while _matrixDirty is false
+  bool          _matrixDirty;
+  float         _matrix[16];
+
   // inherited from Group
   // vector<Node*> _children;
   // Vec3f         _bboxCenter;
@@ -87,7 +91,12 @@ public:
   void      setScaleOrientation(Vec4f& value);
   void      setTranslation(Vec3f& value);
 
+  // row-major 4x4 matrices; the matrix of the Transform is cached and
+  // only recomputed after one of the fields is changed by a setter
   void      getMatrix(float* T /*[16]*/);
+  // to be called after changing the fields in place, through the
+  // references returned by the getters
+  void      setMatrixDirty();
 
   virtual bool    isTransform() const { return        true; }
   virtual string  getType()     const { return "Transform"; }
@@ -96,10 +105,17 @@ public:
 
   virtual void    printInfo(string indent);
 
+  // W = A * B; the matrix mapping local coordinates to scene graph
+  // coordinates is composed top-down, over a SceneGraphFlat, as the
+  // product of the one of the enclosing Transform and getMatrix()
+  static void multiply(const float* A, const float* B, float* W);
+
 private:
 
   static void _makeRotation(Rotation& r, float* R /*[9]*/);
 
+  void        _computeMatrix(float* M /*[16]*/);
+
 };
 
 #endif /* _Transform_h_ */